@@ -0,0 +1,170 @@
+"""Bakes the 5x7 debug font into src/font_atlas.h.
+
+Usage: python scripts/bake_font.py [output]
+
+Each glyph is stored as an 8x8 cell of coverage bytes, either 0 or FONT_COVERAGE_ONE. The glyph itself fills the
+top-left 5x7 pixels and the unused columns have zero coverage.
+"""
+
+import os
+import sys
+
+FIRST_CHAR = 32
+CELL_WIDTH = 8
+CELL_HEIGHT = 8
+GLYPH_WIDTH = 5
+GLYPH_HEIGHT = 7
+ADVANCE = GLYPH_WIDTH + 1
+LINE_HEIGHT = GLYPH_HEIGHT + 2
+COVERAGE_SHIFT = 7
+COVERAGE_ONE = 1 << COVERAGE_SHIFT
+
+# Printable ASCII, one byte per column from left to right, bit 0 is the top row.
+GLYPHS = [
+    (0x00, 0x00, 0x00, 0x00, 0x00),  # ' '
+    (0x00, 0x00, 0x5F, 0x00, 0x00),  # '!'
+    (0x00, 0x07, 0x00, 0x07, 0x00),  # '"'
+    (0x14, 0x7F, 0x14, 0x7F, 0x14),  # '#'
+    (0x24, 0x2A, 0x7F, 0x2A, 0x12),  # '$'
+    (0x23, 0x13, 0x08, 0x64, 0x62),  # '%'
+    (0x36, 0x49, 0x55, 0x22, 0x50),  # '&'
+    (0x00, 0x05, 0x03, 0x00, 0x00),  # '''
+    (0x00, 0x1C, 0x22, 0x41, 0x00),  # '('
+    (0x00, 0x41, 0x22, 0x1C, 0x00),  # ')'
+    (0x08, 0x2A, 0x1C, 0x2A, 0x08),  # '*'
+    (0x08, 0x08, 0x3E, 0x08, 0x08),  # '+'
+    (0x00, 0x50, 0x30, 0x00, 0x00),  # ','
+    (0x08, 0x08, 0x08, 0x08, 0x08),  # '-'
+    (0x00, 0x60, 0x60, 0x00, 0x00),  # '.'
+    (0x20, 0x10, 0x08, 0x04, 0x02),  # '/'
+    (0x3E, 0x51, 0x49, 0x45, 0x3E),  # '0'
+    (0x00, 0x42, 0x7F, 0x40, 0x00),  # '1'
+    (0x42, 0x61, 0x51, 0x49, 0x46),  # '2'
+    (0x21, 0x41, 0x45, 0x4B, 0x31),  # '3'
+    (0x18, 0x14, 0x12, 0x7F, 0x10),  # '4'
+    (0x27, 0x45, 0x45, 0x45, 0x39),  # '5'
+    (0x3C, 0x4A, 0x49, 0x49, 0x30),  # '6'
+    (0x01, 0x71, 0x09, 0x05, 0x03),  # '7'
+    (0x36, 0x49, 0x49, 0x49, 0x36),  # '8'
+    (0x06, 0x49, 0x49, 0x29, 0x1E),  # '9'
+    (0x00, 0x36, 0x36, 0x00, 0x00),  # ':'
+    (0x00, 0x56, 0x36, 0x00, 0x00),  # ';'
+    (0x08, 0x14, 0x22, 0x41, 0x00),  # '<'
+    (0x14, 0x14, 0x14, 0x14, 0x14),  # '='
+    (0x00, 0x41, 0x22, 0x14, 0x08),  # '>'
+    (0x02, 0x01, 0x51, 0x09, 0x06),  # '?'
+    (0x32, 0x49, 0x79, 0x41, 0x3E),  # '@'
+    (0x7E, 0x11, 0x11, 0x11, 0x7E),  # 'A'
+    (0x7F, 0x49, 0x49, 0x49, 0x36),  # 'B'
+    (0x3E, 0x41, 0x41, 0x41, 0x22),  # 'C'
+    (0x7F, 0x41, 0x41, 0x22, 0x1C),  # 'D'
+    (0x7F, 0x49, 0x49, 0x49, 0x41),  # 'E'
+    (0x7F, 0x09, 0x09, 0x09, 0x01),  # 'F'
+    (0x3E, 0x41, 0x49, 0x49, 0x7A),  # 'G'
+    (0x7F, 0x08, 0x08, 0x08, 0x7F),  # 'H'
+    (0x00, 0x41, 0x7F, 0x41, 0x00),  # 'I'
+    (0x20, 0x40, 0x41, 0x3F, 0x01),  # 'J'
+    (0x7F, 0x08, 0x14, 0x22, 0x41),  # 'K'
+    (0x7F, 0x40, 0x40, 0x40, 0x40),  # 'L'
+    (0x7F, 0x02, 0x0C, 0x02, 0x7F),  # 'M'
+    (0x7F, 0x04, 0x08, 0x10, 0x7F),  # 'N'
+    (0x3E, 0x41, 0x41, 0x41, 0x3E),  # 'O'
+    (0x7F, 0x09, 0x09, 0x09, 0x06),  # 'P'
+    (0x3E, 0x41, 0x51, 0x21, 0x5E),  # 'Q'
+    (0x7F, 0x09, 0x19, 0x29, 0x46),  # 'R'
+    (0x46, 0x49, 0x49, 0x49, 0x31),  # 'S'
+    (0x01, 0x01, 0x7F, 0x01, 0x01),  # 'T'
+    (0x3F, 0x40, 0x40, 0x40, 0x3F),  # 'U'
+    (0x1F, 0x20, 0x40, 0x20, 0x1F),  # 'V'
+    (0x3F, 0x40, 0x38, 0x40, 0x3F),  # 'W'
+    (0x63, 0x14, 0x08, 0x14, 0x63),  # 'X'
+    (0x07, 0x08, 0x70, 0x08, 0x07),  # 'Y'
+    (0x61, 0x51, 0x49, 0x45, 0x43),  # 'Z'
+    (0x00, 0x7F, 0x41, 0x41, 0x00),  # '['
+    (0x02, 0x04, 0x08, 0x10, 0x20),  # '\'
+    (0x00, 0x41, 0x41, 0x7F, 0x00),  # ']'
+    (0x04, 0x02, 0x01, 0x02, 0x04),  # '^'
+    (0x40, 0x40, 0x40, 0x40, 0x40),  # '_'
+    (0x00, 0x01, 0x02, 0x04, 0x00),  # '`'
+    (0x20, 0x54, 0x54, 0x54, 0x78),  # 'a'
+    (0x7F, 0x48, 0x44, 0x44, 0x38),  # 'b'
+    (0x38, 0x44, 0x44, 0x44, 0x20),  # 'c'
+    (0x38, 0x44, 0x44, 0x48, 0x7F),  # 'd'
+    (0x38, 0x54, 0x54, 0x54, 0x18),  # 'e'
+    (0x08, 0x7E, 0x09, 0x01, 0x02),  # 'f'
+    (0x0C, 0x52, 0x52, 0x52, 0x3E),  # 'g'
+    (0x7F, 0x08, 0x04, 0x04, 0x78),  # 'h'
+    (0x00, 0x44, 0x7D, 0x40, 0x00),  # 'i'
+    (0x20, 0x40, 0x44, 0x3D, 0x00),  # 'j'
+    (0x7F, 0x10, 0x28, 0x44, 0x00),  # 'k'
+    (0x00, 0x41, 0x7F, 0x40, 0x00),  # 'l'
+    (0x7C, 0x04, 0x18, 0x04, 0x78),  # 'm'
+    (0x7C, 0x08, 0x04, 0x04, 0x78),  # 'n'
+    (0x38, 0x44, 0x44, 0x44, 0x38),  # 'o'
+    (0x7C, 0x14, 0x14, 0x14, 0x08),  # 'p'
+    (0x08, 0x14, 0x14, 0x18, 0x7C),  # 'q'
+    (0x7C, 0x08, 0x04, 0x04, 0x08),  # 'r'
+    (0x48, 0x54, 0x54, 0x54, 0x20),  # 's'
+    (0x04, 0x3F, 0x44, 0x40, 0x20),  # 't'
+    (0x3C, 0x40, 0x40, 0x20, 0x7C),  # 'u'
+    (0x1C, 0x20, 0x40, 0x20, 0x1C),  # 'v'
+    (0x3C, 0x40, 0x30, 0x40, 0x3C),  # 'w'
+    (0x44, 0x28, 0x10, 0x28, 0x44),  # 'x'
+    (0x0C, 0x50, 0x50, 0x50, 0x3C),  # 'y'
+    (0x44, 0x64, 0x54, 0x4C, 0x44),  # 'z'
+    (0x00, 0x08, 0x36, 0x41, 0x00),  # '{'
+    (0x00, 0x00, 0x7F, 0x00, 0x00),  # '|'
+    (0x00, 0x41, 0x36, 0x08, 0x00),  # '}'
+    (0x08, 0x04, 0x08, 0x10, 0x08),  # '~'
+]
+
+
+def bake_glyph(columns):
+    cell = [[0] * CELL_WIDTH for _ in range(CELL_HEIGHT)]
+    for x, bits in enumerate(columns):
+        for y in range(GLYPH_HEIGHT):
+            if (bits >> y) & 1:
+                cell[y][x] = COVERAGE_ONE
+    return cell
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "src", "font_atlas.h")
+
+    lines = [
+        "// Generated by scripts/bake_font.py, do not edit.",
+        "#pragma once",
+        '#include "types.h"',
+        "",
+        "namespace gfx {",
+        "",
+        "// Printable ASCII, characters outside [FONT_FIRST_CHAR, FONT_FIRST_CHAR + FONT_GLYPH_COUNT) have no glyph.",
+        f"static constexpr u32 FONT_FIRST_CHAR = {FIRST_CHAR};",
+        f"static constexpr u32 FONT_GLYPH_COUNT = {len(GLYPHS)};",
+        "// Atlas cell of one glyph, the glyph fills its top-left FONT_GLYPH_WIDTH x FONT_GLYPH_HEIGHT pixels.",
+        f"static constexpr u32 FONT_CELL_WIDTH = {CELL_WIDTH};",
+        f"static constexpr u32 FONT_CELL_HEIGHT = {CELL_HEIGHT};",
+        f"static constexpr u32 FONT_GLYPH_WIDTH = {GLYPH_WIDTH};",
+        f"static constexpr u32 FONT_GLYPH_HEIGHT = {GLYPH_HEIGHT};",
+        f"static constexpr u32 FONT_ADVANCE = {ADVANCE};",
+        f"static constexpr u32 FONT_LINE_HEIGHT = {LINE_HEIGHT};",
+        f"static constexpr u32 FONT_COVERAGE_SHIFT = {COVERAGE_SHIFT};",
+        "static constexpr u32 FONT_COVERAGE_ONE = 1u << FONT_COVERAGE_SHIFT;",
+        "",
+        "// Glyph-major, FONT_CELL_HEIGHT rows of FONT_CELL_WIDTH coverage bytes per glyph.",
+        "alignas(16) inline constexpr u8 FONT_ATLAS[FONT_GLYPH_COUNT * FONT_CELL_HEIGHT * FONT_CELL_WIDTH] = {",
+    ]
+    for index, columns in enumerate(GLYPHS):
+        char = chr(FIRST_CHAR + index)
+        lines.append(f"    // '{char}'" if char != "\\" else "    // backslash")
+        for row in bake_glyph(columns):
+            lines.append("    " + ", ".join(f"{value:3d}" for value in row) + ",")
+    lines += ["};", "", "} // namespace gfx", ""]
+
+    with open(output, "w", newline="\n") as file:
+        file.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,21 +1,91 @@
 #include "app.h"
 #include "logger.h"
+#include "overlay.h"
 #include "renderer.h"
+#include "scene.h"
 #include <SDL_timer.h>
 #include <SDL_video.h>
+#include <algorithm>
+#include <string_view>
+#include <thread>
 
 gfx::App* app;
 
 gfx::Mesh cube;
+gfx::Scene scene;
+
+// Top-left stats panel, drawn into the color buffer like the rest of the frame. Fixed size so DirtyTiles frames can
+// mark it before it's drawn.
+static constexpr gfx::s32 STATS_PADDING = 4;
+static constexpr gfx::s32 STATS_WIDTH = 32 * (gfx::s32)gfx::FONT_ADVANCE + 2 * STATS_PADDING;
+static constexpr gfx::s32 STATS_HEIGHT = 4 * (gfx::s32)gfx::FONT_LINE_HEIGHT + 2 * STATS_PADDING;
 
 void DrawStats(gfx::App* app) {
-    ImGui::Begin("Dummy", 0,
-                 ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
-                     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs);
+    using namespace gfx;
+    Renderer* renderer = &app->renderer;
+    char sort_last_line[40] = "";
+    if (app->sort_last.header != nullptr) {
+        FormatText(sort_last_line, "\nSort-Last Processes: {}", app->sort_last.process_count);
+    }
+    char text[160];
+    FormatText(text, "Frame Time: {:.1f}ms\nVisible Instances: {}/{}\nRender Resolution: {}x{}{}",
+               app->timestep.frame_time_ms, scene.visible_instances.size(), scene.instances.size(),
+               renderer->buffer_width, renderer->buffer_height, sort_last_line);
+
+    DrawOverlayRect(renderer, 0, 0, STATS_WIDTH, STATS_HEIGHT, RGB(24, 24, 24));
+    DrawOverlayText(renderer, STATS_PADDING, STATS_PADDING, text, RGB(255, 255, 255));
+}
+
+// Loads the scene, or this process' share of it when rendering sort-last.
+static bool LoadScene(gfx::App* app) {
+    using namespace gfx;
+    if (!ImportMeshFromSceneFile(&cube, "meshes/cube.obj")) {
+        return false;
+    }
+    if (app->settings.quantize_meshes) {
+        QuantizeMesh(&cube);
+    }
+
+    // Instance grid, most of it ends up outside the view at any given time.
+    u32 instance_index = 0;
+    for (s32 z = 0; z < 32; ++z) {
+        for (s32 x = 0; x < 32; ++x) {
+            if (IsSortLastShare(&app->sort_last, instance_index++)) {
+                vec3f position = vec3f((f32)(x - 16) * 5.0f, -3.0f, (f32)(z - 16) * 5.0f);
+                AddMeshInstance(&scene, &cube, glm::translate(glm::mat4(1.0f), position));
+            }
+        }
+    }
+    return true;
+}
 
-    ImGui::Text("Frame Time: %0.1fms", app->timestep.frame_time_ms);
-    ImGui::SetWindowPos(ImVec2(0.0f, 0.0f));
-    ImGui::End();
+// Main loop of a renderer process launched by the sort-last compositor, no window and no UI.
+static int RunSortLastProcess(gfx::App* app) {
+    using namespace gfx;
+    SortLast* sort_last = &app->sort_last;
+    if (!AttachSortLast(sort_last, app->settings.sort_last_shared_memory_name, app->settings.sort_last_process_index)) {
+        Cleanup(app);
+        return EXIT_FAILURE;
+    }
+
+    Renderer* renderer = &app->renderer;
+    if (!InitHeadlessRenderer(renderer, sort_last->width, sort_last->height, app->settings.renderer) ||
+        !LoadScene(app)) {
+        Cleanup(app);
+        return EXIT_FAILURE;
+    }
+
+    SortLastFrame frame;
+    while (WaitForSortLastFrame(sort_last, &frame)) {
+        scene.lod_pixel_error = frame.lod_pixel_error;
+        scene.use_depth_prepass = frame.use_depth_prepass;
+        ClearBuffers(renderer);
+        DrawScene(renderer, &scene, &frame.camera);
+        WriteSortLastLayer(sort_last, renderer);
+    }
+
+    Cleanup(app);
+    return EXIT_SUCCESS;
 }
 
 int gfx::Run(int argc, char** argv) {
@@ -23,6 +93,11 @@ int gfx::Run(int argc, char** argv) {
     app = new App();
 
     gfx::InitLogger();
+    ParseCommandLine(&app->settings, argc, argv);
+
+    if (app->settings.sort_last_shared_memory_name != nullptr) {
+        return RunSortLastProcess(app);
+    }
 
     // Initialize SDL
     // Create an SDL Window
@@ -47,13 +122,20 @@ int gfx::Run(int argc, char** argv) {
         return false;
     }
 
-    if (!InitRenderer(app->window, &app->renderer)) {
+    if (!InitRenderer(app->window, &app->renderer, app->settings.renderer)) {
         return false;
     }
 
     InitImGui(app->window, app->renderer.sdl_renderer);
+    app->dynamic_resolution.target_frame_time_ms = app->settings.target_frame_time_ms;
 
-    if (!ImportMeshFromSceneFile(&cube, "meshes/cube.obj")) {
+    if (app->settings.sort_last_process_count > 1 &&
+        !StartSortLast(&app->sort_last, app->settings.sort_last_process_count, app->renderer.max_buffer_width,
+                       app->renderer.max_buffer_height, argc, argv)) {
+        return false;
+    }
+
+    if (!LoadScene(app)) {
         return false;
     }
 
@@ -76,24 +158,54 @@ int gfx::Run(int argc, char** argv) {
 
         Renderer* renderer = &app->renderer;
 
+        // Resolution follows the last frame's time, a change is a full redraw.
+        if (renderer->is_resolution_dynamic &&
+            UpdateDynamicResolution(&app->dynamic_resolution, app->timestep.frame_time_ms)) {
+            SetRenderScale(renderer, app->dynamic_resolution.scale);
+        }
+
         ImGui_ImplSDLRenderer_NewFrame();
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
 
+        // Decides how much of the last frame survives. A UI widget being dragged may change anything drawn
+        // immediate-mode, so redraw everything then.
+        TrackSceneChanges(renderer, &scene, &app->camera_controller);
+        if (ImGui::IsAnyItemActive()) {
+            SetFrameUpdate(renderer, FrameUpdate::Full);
+        }
+        // The stats change every frame, their panel is redrawn from a clean tile. Reused frames keep the last drawn
+        // stats.
+        if (renderer->frame_update == FrameUpdate::DirtyTiles) {
+            MarkDirtyRect(renderer, vec2f(0.0f), vec2f((f32)STATS_WIDTH, (f32)STATS_HEIGHT));
+        }
+        // Immediate-mode drawing would race the previous frame's raster jobs when pipelined and there's no color
+        // buffer to draw into when the last frame is reused. Whatever goes under the scene must also stay inside the
+        // tiles a DirtyTiles frame redraws, elsewhere the previous frame's scene is already on top of it.
+        bool const can_draw_immediate = !renderer->is_pipelined && renderer->frame_update != FrameUpdate::Reuse;
+
+        // The other processes render their shares while this one renders its own.
+        bool const is_sort_last = app->sort_last.header != nullptr;
+        if (is_sort_last) {
+            BeginSortLastFrame(&app->sort_last,
+                               {app->camera_controller, scene.lod_pixel_error, scene.use_depth_prepass});
+        }
+
         ClearBuffers(renderer);
 
+        static vec2f vtx_pos0 = {150.0f, 100.0f};
+        static vec2f vtx_pos1 = {400.0f, 400.0f};
+        static vec2f vtx_pos2 = {550.0f, 200.0f};
+        static Triangle2D test_triangle{ 0,  vtx_pos0, vtx_pos1, vtx_pos2, "Test Triangle"};
         {
-            static vec2f vtx_pos0 = {150.0f, 100.0f};
-            static vec2f vtx_pos1 = {400.0f, 400.0f};
-            static vec2f vtx_pos2 = {550.0f, 200.0f};
-            static Triangle2D test_triangle{ 0,  vtx_pos0, vtx_pos1, vtx_pos2, "Test Triangle"};
 						ImGui::Begin("Triangle Settings");
 						ImGui::DragFloat2("V0", (float*)&test_triangle.vtx_pos0, 1.f, 0.0f,10000.0f);
 						ImGui::DragFloat2("V1", (float*)&test_triangle.vtx_pos1, 1.f, 0.0f,10000.0f);
 						ImGui::DragFloat2("V2", (float*)&test_triangle.vtx_pos2, 1.f, 0.0f,10000.0f);
 						ImGui::End();
-            DrawTriangle2D(renderer, &test_triangle);
-            BinTriangle2D_L0(renderer, &test_triangle);
+            if (can_draw_immediate) {
+                DrawTriangle2D(renderer, &test_triangle);
+            }
         }
 
         // Options
@@ -107,6 +219,30 @@ int gfx::Run(int argc, char** argv) {
         //     ImGui::End();
         // }
 
+        // Scene
+        {
+            DrawScene(renderer, &scene, &app->camera_controller);
+            if (is_sort_last) {
+                WriteSortLastLayer(&app->sort_last, renderer);
+                if (!CompositeSortLast(&app->sort_last, renderer)) {
+                    app->is_running = false;
+                }
+            }
+            ImGui::Begin("Scene");
+            ImGui::Checkbox("Depth Prepass", &scene.use_depth_prepass);
+            // The other processes' layers would cover this one's lines, they don't write depth.
+            if (!is_sort_last) {
+                ImGui::Checkbox("Wireframe", &scene.show_wireframe);
+            }
+            ImGui::End();
+        }
+
+        // Overlays go on top of the finished scene.
+        if (can_draw_immediate) {
+            BinTriangle2D_L0(renderer, &test_triangle);
+            DrawStats(app);
+        }
+
         // Mesh
         // {
         //     f32 angle = (f32)(SDL_GetTicks()) * 0.001f;
@@ -129,7 +265,81 @@ int gfx::Run(int argc, char** argv) {
     return EXIT_SUCCESS;
 }
 
+void gfx::ParseCommandLine(AppSettings* settings, int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) {
+            settings->renderer.worker_count = (u32)std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--pin-workers") {
+            settings->renderer.pin_workers_to_cores = true;
+        } else if (arg == "--copy-present") {
+            settings->renderer.present_mode = PresentMode::Copy;
+        } else if (arg == "--async-present") {
+            settings->renderer.async_present = true;
+        } else if (arg == "--pipelined") {
+            settings->renderer.pipelined = true;
+        } else if (arg == "--depth-format" && i + 1 < argc) {
+            std::string_view format = argv[++i];
+            if (format == "unorm16") {
+                settings->renderer.depth_format = DepthFormat::Unorm16;
+            } else if (format == "unorm24") {
+                settings->renderer.depth_format = DepthFormat::Unorm24;
+            } else if (format == "float32") {
+                settings->renderer.depth_format = DepthFormat::Float32;
+            } else {
+                gfx_warn("Unknown depth format: {0}", format);
+            }
+        } else if (arg == "--no-depth-compression") {
+            settings->renderer.compress_depth = false;
+        } else if (arg == "--incremental") {
+            settings->renderer.incremental = true;
+        } else if (arg == "--quantize-meshes") {
+            settings->quantize_meshes = true;
+        } else if (arg == "--sort-last" && i + 1 < argc) {
+            u32 const process_count = (u32)std::strtoul(argv[++i], nullptr, 10);
+            if (process_count >= 1 && process_count <= SORT_LAST_MAX_PROCESSES) {
+                settings->sort_last_process_count = process_count;
+            } else {
+                gfx_warn("Sort-last process count must be 1 to {0}: {1}", SORT_LAST_MAX_PROCESSES, argv[i]);
+            }
+        } else if (arg == "--sort-last-process" && i + 1 < argc) {
+            settings->sort_last_process_index = (u32)std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--sort-last-shm" && i + 1 < argc) {
+            settings->sort_last_shared_memory_name = argv[++i];
+        } else if (arg == "--dynamic-resolution") {
+            settings->renderer.dynamic_resolution = true;
+        } else if (arg == "--target-frame-ms" && i + 1 < argc) {
+            f32 const target = std::strtof(argv[++i], nullptr);
+            if (target > 0.0f) {
+                settings->target_frame_time_ms = target;
+            } else {
+                gfx_warn("Invalid target frame time: {0}", argv[i]);
+            }
+        } else {
+            gfx_warn("Unknown argument: {0}", arg);
+        }
+    }
+
+    // Every process renders a full frame at the window size right after DrawScene, and the processes share the
+    // machine's cores. Compositing reads this process's frame back, which the write-only locked texture can't provide.
+    if (settings->sort_last_process_count > 1) {
+        RendererSettings& renderer = settings->renderer;
+        renderer.present_mode = PresentMode::Copy;
+        if (renderer.pipelined || renderer.incremental || renderer.dynamic_resolution) {
+            gfx_warn("Pipelining, incremental rendering and dynamic resolution are not available with sort-last.");
+            renderer.pipelined = false;
+            renderer.incremental = false;
+            renderer.dynamic_resolution = false;
+        }
+        if (renderer.worker_count == 0) {
+            renderer.worker_count =
+                std::max(1u, std::thread::hardware_concurrency() / settings->sort_last_process_count);
+        }
+    }
+}
+
 void gfx::Cleanup(App* app) {
+    StopSortLast(&app->sort_last);
     CleanupRenderer(&app->renderer);
     if (app->window != nullptr) {
         SDL_DestroyWindow(app->window);
@@ -2,14 +2,30 @@
 #include "SDL2/SDL.h"
 #include "logger.h"
 #include "renderer.h"
+#include "dynamic_resolution.h"
 #include "flying_camera_controller.h"
 #include "input.h"
+#include "sort_last.h"
 #include <cstdint>
 
 namespace gfx {
 
+// Per-run options, parsed from the command line.
+struct AppSettings {
+    RendererSettings renderer;
+    f32 target_frame_time_ms = 33.3f;
+    // Store imported meshes in QuantizedMesh form.
+    bool quantize_meshes = false;
+    // Processes the scene is split across, 1 renders everything in this one.
+    u32 sort_last_process_count = 1;
+    // Set on the renderer processes the compositor launches, they render headless into the named shared memory.
+    u32 sort_last_process_index = 0;
+    char const* sort_last_shared_memory_name = nullptr;
+};
+
 struct App {
     bool is_running = true;
+    AppSettings settings;
     SDL_Window* window;
     Renderer renderer;
     struct {
@@ -17,6 +33,8 @@ struct App {
         f64 frame_time_ms = 0.0;
     } timestep;
     u64 perf_counter = 0;
+    DynamicResolution dynamic_resolution;
+    SortLast sort_last;
 		FlyingCameraController camera_controller;
 		bool trap_mouse = false;
 };
@@ -25,6 +43,7 @@ static App* app;
 __forceinline App* GetApp() { return app; }
 
 int Run(int argc, char** argv);
+void ParseCommandLine(AppSettings* settings, int argc, char** argv);
 void Cleanup(App* app);
 void ProcessWindowEvents(App* app, SDL_Event& e);
 } // namespace gfx
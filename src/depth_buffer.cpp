@@ -0,0 +1,205 @@
+#include "depth_buffer.h"
+#include "logger.h"
+#include <new>
+
+namespace gfx {
+
+static size_t GetDepthFormatSize(DepthFormat format) {
+    return format == DepthFormat::Unorm16 ? sizeof(u16) : sizeof(u32);
+}
+
+bool InitDepthBuffer(DepthBuffer* depth_buffer, size_t width, size_t height, DepthFormat format,
+                     bool enable_compression) {
+    depth_buffer->format = format;
+    depth_buffer->is_compression_enabled = enable_compression;
+    depth_buffer->width = width;
+    depth_buffer->height = height;
+    depth_buffer->tile_count_x = (width + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+    depth_buffer->tile_count_y = (height + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+
+    size_t const tile_count = depth_buffer->tile_count_x * depth_buffer->tile_count_y;
+    depth_buffer->tiles.resize(tile_count);
+    depth_buffer->size_in_bytes = tile_count * DEPTH_TILE_PIXEL_COUNT * GetDepthFormatSize(format);
+    depth_buffer->pixels =
+        static_cast<u8*>(::operator new(depth_buffer->size_in_bytes, std::align_val_t(64), std::nothrow));
+    if (depth_buffer->pixels == nullptr) {
+        gfx_error("Depth buffer could not be allocated.");
+        return false;
+    }
+
+    ClearDepthTiles(depth_buffer, 0, 0, width, height);
+    return true;
+}
+
+void DestroyDepthBuffer(DepthBuffer* depth_buffer) {
+    if (depth_buffer->pixels != nullptr) {
+        ::operator delete(depth_buffer->pixels, std::align_val_t(64));
+    }
+    *depth_buffer = DepthBuffer{};
+}
+
+bool ResizeDepthBuffer(DepthBuffer* depth_buffer, size_t width, size_t height) {
+    size_t const tile_count_x = (width + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+    size_t const tile_count_y = (height + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+    size_t const tile_count = tile_count_x * tile_count_y;
+    if (tile_count * DEPTH_TILE_PIXEL_COUNT * GetDepthFormatSize(depth_buffer->format) > depth_buffer->size_in_bytes) {
+        gfx_error("Depth buffer can't be resized past its allocation.");
+        return false;
+    }
+
+    depth_buffer->width = width;
+    depth_buffer->height = height;
+    depth_buffer->tile_count_x = tile_count_x;
+    depth_buffer->tile_count_y = tile_count_y;
+    depth_buffer->tiles.resize(tile_count);
+    ClearDepthTiles(depth_buffer, 0, 0, width, height);
+    return true;
+}
+
+void ClearDepthTiles(DepthBuffer* depth_buffer, size_t x0, size_t y0, size_t x1, size_t y1) {
+    size_t const tile_x0 = x0 / DEPTH_TILE_SIZE;
+    size_t const tile_y0 = y0 / DEPTH_TILE_SIZE;
+    size_t const tile_x1 = std::min((x1 + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE, depth_buffer->tile_count_x);
+    size_t const tile_y1 = std::min((y1 + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE, depth_buffer->tile_count_y);
+    size_t const tile_size_in_bytes = DEPTH_TILE_PIXEL_COUNT * GetDepthFormatSize(depth_buffer->format);
+
+    for (size_t tile_y = tile_y0; tile_y < tile_y1; ++tile_y) {
+        for (size_t tile_x = tile_x0; tile_x < tile_x1; ++tile_x) {
+            size_t const tile_index = tile_y * depth_buffer->tile_count_x + tile_x;
+            DepthTile& tile = depth_buffer->tiles[tile_index];
+            if (depth_buffer->is_compression_enabled) {
+                tile.state = DepthTileState::Clear;
+            } else {
+                // The clear value encodes to 0 in every format.
+                tile.state = DepthTileState::Decompressed;
+                std::memset(depth_buffer->pixels + tile_index * tile_size_in_bytes, 0, tile_size_in_bytes);
+            }
+        }
+    }
+}
+
+void ResolveDepthRows(DepthBuffer const* depth_buffer, size_t y0, size_t y1, f32* pixels, size_t stride) {
+    y1 = std::min(y1, depth_buffer->height);
+    for (size_t y = y0; y < y1; ++y) {
+        f32* row = pixels + (y - y0) * stride;
+        size_t const tile_y = y / DEPTH_TILE_SIZE;
+        for (size_t tile_x = 0; tile_x < depth_buffer->tile_count_x; ++tile_x) {
+            DepthTile const& tile = depth_buffer->tiles[tile_y * depth_buffer->tile_count_x + tile_x];
+            size_t const x0 = tile_x * DEPTH_TILE_SIZE;
+            size_t const x1 = std::min(x0 + DEPTH_TILE_SIZE, depth_buffer->width);
+            switch (tile.state) {
+            case DepthTileState::Clear:
+                std::fill(row + x0, row + x1, 0.0f);
+                break;
+            case DepthTileState::Decompressed:
+                for (size_t x = x0; x < x1; ++x) {
+                    row[x] = DecodeDepth(depth_buffer->format, LoadDepth(depth_buffer, x, y));
+                }
+                break;
+            default:
+                for (size_t x = x0; x < x1; ++x) {
+                    row[x] = GetCompressedDepth(tile, x, y);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void DecompressDepthTile(DepthBuffer* depth_buffer, size_t tile_index) {
+    DepthTile& tile = depth_buffer->tiles[tile_index];
+    if (tile.state == DepthTileState::Decompressed)
+        return;
+
+    if (tile.state == DepthTileState::Clear) {
+        // The clear value encodes to 0 in every format.
+        size_t const tile_size_in_bytes = DEPTH_TILE_PIXEL_COUNT * GetDepthFormatSize(depth_buffer->format);
+        std::memset(depth_buffer->pixels + tile_index * tile_size_in_bytes, 0, tile_size_in_bytes);
+        tile.state = DepthTileState::Decompressed;
+        return;
+    }
+
+    size_t x0, y0, x1, y1;
+    GetDepthTileRect(depth_buffer, tile_index, x0, y0, x1, y1);
+    for (size_t y = y0; y < y1; ++y) {
+        for (size_t x = x0; x < x1; ++x) {
+            StoreDepth(depth_buffer, x, y, EncodeDepth(depth_buffer->format, GetCompressedDepth(tile, x, y)));
+        }
+    }
+    tile.state = DepthTileState::Decompressed;
+}
+
+void UpdateCompressedDepthTile(DepthBuffer* depth_buffer, size_t tile_index, DepthPlane const& plane,
+                               u16 const write_mask[DEPTH_TILE_SIZE]) {
+    DepthTile& tile = depth_buffer->tiles[tile_index];
+
+    size_t x0, y0, x1, y1;
+    GetDepthTileRect(depth_buffer, tile_index, x0, y0, x1, y1);
+    u16 const valid_row_mask = (u16)((1u << (x1 - x0)) - 1);
+    size_t const row_count = y1 - y0;
+
+    bool is_any_written = false;
+    bool is_fully_written = true;
+    // Whether the write replaces every pixel of planes[1] / planes[0].
+    bool covers_plane1 = true;
+    bool covers_plane0 = true;
+    for (size_t row = 0; row < row_count; ++row) {
+        u16 const written = write_mask[row];
+        u16 const plane1_pixels = tile.plane_mask[row];
+        u16 const plane0_pixels = (u16)(~plane1_pixels & valid_row_mask);
+        is_any_written |= written != 0;
+        is_fully_written &= written == valid_row_mask;
+        covers_plane1 &= (written & plane1_pixels) == plane1_pixels;
+        covers_plane0 &= (written & plane0_pixels) == plane0_pixels;
+    }
+
+    if (!is_any_written)
+        return;
+
+    if (is_fully_written) {
+        tile.state = DepthTileState::OnePlane;
+        tile.planes[0] = plane;
+        return;
+    }
+
+    switch (tile.state) {
+    case DepthTileState::Clear:
+        tile.planes[0] = DepthPlane{};
+        [[fallthrough]];
+    case DepthTileState::OnePlane:
+        tile.state = DepthTileState::TwoPlanes;
+        tile.planes[1] = plane;
+        std::copy(write_mask, write_mask + DEPTH_TILE_SIZE, tile.plane_mask);
+        return;
+    case DepthTileState::TwoPlanes:
+        if (covers_plane1) {
+            tile.planes[1] = plane;
+            std::copy(write_mask, write_mask + DEPTH_TILE_SIZE, tile.plane_mask);
+            return;
+        }
+        if (covers_plane0) {
+            tile.planes[0] = plane;
+            for (size_t row = 0; row < DEPTH_TILE_SIZE; ++row) {
+                tile.plane_mask[row] &= (u16)~write_mask[row];
+            }
+            return;
+        }
+        break;
+    case DepthTileState::Decompressed:
+        break;
+    }
+
+    // A third plane, fall back to per-pixel values.
+    DecompressDepthTile(depth_buffer, tile_index);
+    for (size_t row = 0; row < row_count; ++row) {
+        for (size_t column = 0; column < x1 - x0; ++column) {
+            if ((write_mask[row] >> column) & 1) {
+                size_t const x = x0 + column;
+                size_t const y = y0 + row;
+                StoreDepth(depth_buffer, x, y, EncodeDepth(depth_buffer->format, EvaluateDepthPlane(plane, x, y)));
+            }
+        }
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,182 @@
+#pragma once
+#include "types.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace gfx {
+
+// Depth is 1/w, which is linear in screen-space and runs from 1 at the near plane (w = 1) to 0 at infinity. That's
+// reversed-Z with an infinite far plane: the clear value is 0 and the test is GREATER_EQUAL.
+static constexpr size_t DEPTH_TILE_SIZE = 16;
+static constexpr size_t DEPTH_TILE_PIXEL_COUNT = DEPTH_TILE_SIZE * DEPTH_TILE_SIZE;
+
+enum class DepthFormat : u8 {
+    Unorm16,
+    // Stored in 32 bits, the top byte is unused.
+    Unorm24,
+    // Reversed-Z keeps float precision where 1/w gets small, far away.
+    Float32
+};
+
+// depth(x, y) = a * (x + 0.5) + b * (y + 0.5) + c, in raster space.
+struct DepthPlane {
+    f32 a = 0.0f;
+    f32 b = 0.0f;
+    f32 c = 0.0f;
+};
+
+enum class DepthTileState : u8 {
+    // Every pixel holds the clear value, nothing in memory.
+    Clear,
+    // planes[0] covers the tile.
+    OnePlane,
+    // planes[1] where the pixel's plane_mask bit is set, planes[0] elsewhere.
+    TwoPlanes,
+    // Per-pixel values live in DepthBuffer::pixels.
+    Decompressed
+};
+
+struct DepthTile {
+    DepthTileState state = DepthTileState::Clear;
+    // One row per u16, bit x of row y is pixel (x, y) of the tile.
+    u16 plane_mask[DEPTH_TILE_SIZE] = {};
+    DepthPlane planes[2];
+};
+
+struct DepthBuffer {
+    DepthFormat format = DepthFormat::Float32;
+    bool is_compression_enabled = true;
+    size_t width = 0;
+    size_t height = 0;
+    size_t tile_count_x = 0;
+    size_t tile_count_y = 0;
+    std::vector<DepthTile> tiles;
+    // Tile-major, DEPTH_TILE_PIXEL_COUNT values per tile so a tile is contiguous in memory.
+    u8* pixels = nullptr;
+    size_t size_in_bytes = 0;
+};
+
+bool InitDepthBuffer(DepthBuffer* depth_buffer, size_t width, size_t height, DepthFormat format,
+                     bool enable_compression = true);
+void DestroyDepthBuffer(DepthBuffer* depth_buffer);
+// Uses the top-left width x height of the allocation, which never grows past its initial size. Every tile is cleared,
+// the tile layout follows the new width.
+bool ResizeDepthBuffer(DepthBuffer* depth_buffer, size_t width, size_t height);
+// Clears the tiles overlapping the raster-space rect [x0, x1) x [y0, y1). Only tile states are written, unless
+// compression is disabled.
+void ClearDepthTiles(DepthBuffer* depth_buffer, size_t x0, size_t y0, size_t x1, size_t y1);
+
+// Writes the depth of rows [y0, y1) as floats into a row-major image with `stride` floats per row, whatever state the
+// tiles are in.
+void ResolveDepthRows(DepthBuffer const* depth_buffer, size_t y0, size_t y1, f32* pixels, size_t stride);
+
+// Writes the tile's current depth into `pixels` and switches it to Decompressed.
+void DecompressDepthTile(DepthBuffer* depth_buffer, size_t tile_index);
+// Records that `plane` won the pixels in `write_mask` of a compressed tile. Stays compressed when the result still
+// fits in two planes, decompresses otherwise.
+void UpdateCompressedDepthTile(DepthBuffer* depth_buffer, size_t tile_index, DepthPlane const& plane,
+                               u16 const write_mask[DEPTH_TILE_SIZE]);
+
+__forceinline size_t GetDepthTileIndex(DepthBuffer const* depth_buffer, size_t x, size_t y) {
+    return (y / DEPTH_TILE_SIZE) * depth_buffer->tile_count_x + x / DEPTH_TILE_SIZE;
+}
+
+// Pixel rect [x0, x1) x [y0, y1) of a tile, clipped to the buffer.
+__forceinline void GetDepthTileRect(DepthBuffer const* depth_buffer, size_t tile_index, size_t& x0, size_t& y0,
+                                    size_t& x1, size_t& y1) {
+    x0 = (tile_index % depth_buffer->tile_count_x) * DEPTH_TILE_SIZE;
+    y0 = (tile_index / depth_buffer->tile_count_x) * DEPTH_TILE_SIZE;
+    x1 = std::min(x0 + DEPTH_TILE_SIZE, depth_buffer->width);
+    y1 = std::min(y0 + DEPTH_TILE_SIZE, depth_buffer->height);
+}
+
+__forceinline f32 EvaluateDepthPlane(DepthPlane const& plane, size_t x, size_t y) {
+    return plane.a * ((f32)x + 0.5f) + plane.b * ((f32)y + 0.5f) + plane.c;
+}
+
+// Depth of a pixel in a tile that isn't Decompressed.
+__forceinline f32 GetCompressedDepth(DepthTile const& tile, size_t x, size_t y) {
+    switch (tile.state) {
+    case DepthTileState::OnePlane:
+        return EvaluateDepthPlane(tile.planes[0], x, y);
+    case DepthTileState::TwoPlanes: {
+        bool const is_plane1 = (tile.plane_mask[y % DEPTH_TILE_SIZE] >> (x % DEPTH_TILE_SIZE)) & 1;
+        return EvaluateDepthPlane(tile.planes[is_plane1 ? 1 : 0], x, y);
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+// Maps depth to the stored integer, larger is always nearer so the depth test is an unsigned compare in every format.
+__forceinline u32 EncodeDepth(DepthFormat format, f32 depth) {
+    depth = std::clamp(depth, 0.0f, 1.0f);
+    switch (format) {
+    case DepthFormat::Unorm16:
+        return (u32)(depth * 65535.0f + 0.5f);
+    case DepthFormat::Unorm24:
+        return (u32)(depth * 16777215.0f + 0.5f);
+    case DepthFormat::Float32:
+    default: {
+        // Non-negative floats order the same as their bit patterns.
+        u32 bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits;
+    }
+    }
+}
+
+// Inverse of EncodeDepth, up to the format's precision.
+__forceinline f32 DecodeDepth(DepthFormat format, u32 depth) {
+    switch (format) {
+    case DepthFormat::Unorm16:
+        return (f32)depth / 65535.0f;
+    case DepthFormat::Unorm24:
+        return (f32)depth / 16777215.0f;
+    case DepthFormat::Float32:
+    default: {
+        f32 value;
+        std::memcpy(&value, &depth, sizeof(value));
+        return value;
+    }
+    }
+}
+
+// Depths closer than this may encode to the same value, 0 when the format keeps every f32.
+__forceinline f32 GetDepthEncodingStep(DepthFormat format) {
+    switch (format) {
+    case DepthFormat::Unorm16:
+        return 1.0f / 65535.0f;
+    case DepthFormat::Unorm24:
+        return 1.0f / 16777215.0f;
+    case DepthFormat::Float32:
+    default:
+        return 0.0f;
+    }
+}
+
+__forceinline size_t GetDepthPixelOffset(DepthBuffer const* depth_buffer, size_t x, size_t y) {
+    return GetDepthTileIndex(depth_buffer, x, y) * DEPTH_TILE_PIXEL_COUNT + (y % DEPTH_TILE_SIZE) * DEPTH_TILE_SIZE +
+           x % DEPTH_TILE_SIZE;
+}
+
+// Encoded depth of a pixel in a Decompressed tile.
+__forceinline u32 LoadDepth(DepthBuffer const* depth_buffer, size_t x, size_t y) {
+    size_t const offset = GetDepthPixelOffset(depth_buffer, x, y);
+    if (depth_buffer->format == DepthFormat::Unorm16) {
+        return reinterpret_cast<u16 const*>(depth_buffer->pixels)[offset];
+    }
+    return reinterpret_cast<u32 const*>(depth_buffer->pixels)[offset];
+}
+
+__forceinline void StoreDepth(DepthBuffer* depth_buffer, size_t x, size_t y, u32 depth) {
+    size_t const offset = GetDepthPixelOffset(depth_buffer, x, y);
+    if (depth_buffer->format == DepthFormat::Unorm16) {
+        reinterpret_cast<u16*>(depth_buffer->pixels)[offset] = (u16)depth;
+    } else {
+        reinterpret_cast<u32*>(depth_buffer->pixels)[offset] = depth;
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,36 @@
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gfx {
+
+bool UpdateDynamicResolution(DynamicResolution* controller, f64 frame_time_ms) {
+    // A single spike (page fault, another process) shouldn't cost resolution.
+    if (controller->smoothed_frame_time_ms == 0.0f) {
+        controller->smoothed_frame_time_ms = (f32)frame_time_ms;
+    } else {
+        controller->smoothed_frame_time_ms +=
+            controller->smoothing * ((f32)frame_time_ms - controller->smoothed_frame_time_ms);
+    }
+
+    ++controller->frames_since_change;
+    if (controller->frames_since_change < DYNAMIC_RESOLUTION_SETTLE_FRAMES)
+        return false;
+
+    f32 const budget_ratio = controller->smoothed_frame_time_ms / controller->target_frame_time_ms;
+    if (budget_ratio <= DYNAMIC_RESOLUTION_OVER_BUDGET && budget_ratio >= DYNAMIC_RESOLUTION_UNDER_BUDGET)
+        return false;
+
+    // Pixel count is scale squared.
+    f32 scale = controller->scale / std::sqrt(budget_ratio);
+    scale = std::min(scale, controller->scale + controller->max_scale_increase);
+    scale = std::clamp(scale, controller->min_scale, controller->max_scale);
+    if (std::abs(scale - controller->scale) < 0.01f)
+        return false;
+
+    controller->scale = scale;
+    controller->frames_since_change = 0;
+    return true;
+}
+
+} // namespace gfx
@@ -0,0 +1,32 @@
+#pragma once
+#include "types.h"
+
+namespace gfx {
+
+// Ratio of frame time to target above which the scale goes down, and below which it's allowed back up. The gap keeps a
+// frame time close to the target from flipping the resolution every few frames.
+static constexpr f32 DYNAMIC_RESOLUTION_OVER_BUDGET = 1.0f;
+static constexpr f32 DYNAMIC_RESOLUTION_UNDER_BUDGET = 0.8f;
+// Frames to wait after a change before judging the new resolution, the smoothed frame time needs them to catch up.
+static constexpr u32 DYNAMIC_RESOLUTION_SETTLE_FRAMES = 8;
+
+// Picks a render scale that holds a frame time budget. Rasterization cost is roughly proportional to the pixel count,
+// i.e. to the square of the scale.
+struct DynamicResolution {
+    f32 target_frame_time_ms = 33.3f;
+    f32 min_scale = 0.25f;
+    f32 max_scale = 1.0f;
+    // Largest increase per change. Drops are taken in one step, a slow frame is worse than a soft one.
+    f32 max_scale_increase = 0.05f;
+    // Weight of the newest frame in the smoothed frame time.
+    f32 smoothing = 0.1f;
+
+    f32 scale = 1.0f;
+    f32 smoothed_frame_time_ms = 0.0f;
+    u32 frames_since_change = 0;
+};
+
+// Feeds the last frame's time, true when `scale` changed.
+bool UpdateDynamicResolution(DynamicResolution* controller, f64 frame_time_ms);
+
+} // namespace gfx
@@ -39,4 +39,8 @@ void update_flying_camera_controller(FlyingCameraController* camera, f32 dt) {
 
     camera->view_transform = glm::lookAtRH(camera->position, camera->position + forward, vec3f(0.0f, 1.0f, 0.0));
 }
+
+glm::mat4 get_flying_camera_projection(FlyingCameraController const* camera, f32 aspect_ratio) {
+    return glm::perspective(camera->fov_y, aspect_ratio, camera->z_near, camera->z_far);
+}
 } // namespace gfx
@@ -16,8 +16,13 @@ struct FlyingCameraController {
     float speed = 10.0f;
     float mouse_sensitivity = 1.0f;
     bool is_enabled = false;
+    // Projection
+    float fov_y = glm::pi<float>() / 2.0f;
+    float z_near = 0.1f;
+    float z_far = 100.0f;
 };
 
 void update_flying_camera_controller(FlyingCameraController* camera, f32 dt);
+glm::mat4 get_flying_camera_projection(FlyingCameraController const* camera, f32 aspect_ratio);
 
 } // namespace gfx
@@ -0,0 +1,879 @@
+// Generated by scripts/bake_font.py, do not edit.
+#pragma once
+#include "types.h"
+
+namespace gfx {
+
+// Printable ASCII, characters outside [FONT_FIRST_CHAR, FONT_FIRST_CHAR + FONT_GLYPH_COUNT) have no glyph.
+static constexpr u32 FONT_FIRST_CHAR = 32;
+static constexpr u32 FONT_GLYPH_COUNT = 95;
+// Atlas cell of one glyph, the glyph fills its top-left FONT_GLYPH_WIDTH x FONT_GLYPH_HEIGHT pixels.
+static constexpr u32 FONT_CELL_WIDTH = 8;
+static constexpr u32 FONT_CELL_HEIGHT = 8;
+static constexpr u32 FONT_GLYPH_WIDTH = 5;
+static constexpr u32 FONT_GLYPH_HEIGHT = 7;
+static constexpr u32 FONT_ADVANCE = 6;
+static constexpr u32 FONT_LINE_HEIGHT = 9;
+static constexpr u32 FONT_COVERAGE_SHIFT = 7;
+static constexpr u32 FONT_COVERAGE_ONE = 1u << FONT_COVERAGE_SHIFT;
+
+// Glyph-major, FONT_CELL_HEIGHT rows of FONT_CELL_WIDTH coverage bytes per glyph.
+alignas(16) inline constexpr u8 FONT_ATLAS[FONT_GLYPH_COUNT * FONT_CELL_HEIGHT * FONT_CELL_WIDTH] = {
+    // ' '
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '!'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '"'
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '#'
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '$'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0, 128,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '%'
+    128, 128,   0,   0,   0,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+      0,   0,   0, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '&'
+      0, 128, 128,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '''
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '('
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // ')'
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '*'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '+'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // ','
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '-'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '.'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '/'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '0'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '1'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '2'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '3'
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '4'
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128, 128,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '5'
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '6'
+      0,   0, 128, 128,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '7'
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '8'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '9'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // ':'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // ';'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '<'
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '='
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '>'
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '?'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '@'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'A'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'B'
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'C'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'D'
+    128, 128, 128,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'E'
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'F'
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'G'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'H'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'I'
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'J'
+      0,   0, 128, 128, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'K'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+    128, 128,   0,   0,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'L'
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'M'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128,   0, 128, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'N'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'O'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'P'
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'Q'
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'R'
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'S'
+      0, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'T'
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'U'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'V'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'W'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'X'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'Y'
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'Z'
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '['
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // backslash
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // ']'
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '^'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '_'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '`'
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'a'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'b'
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0, 128, 128,   0,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'c'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'd'
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'e'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'f'
+      0,   0, 128, 128,   0,   0,   0,   0,
+      0, 128,   0,   0, 128,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128, 128, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'g'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'h'
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0, 128, 128,   0,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'i'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'j'
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0, 128, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'k'
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+    128, 128,   0,   0,   0,   0,   0,   0,
+    128,   0, 128,   0,   0,   0,   0,   0,
+    128,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'l'
+      0, 128, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'm'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128,   0, 128,   0,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'n'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0, 128, 128,   0,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'o'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'p'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'q'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'r'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0, 128, 128,   0,   0,   0,   0,
+    128, 128,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 's'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+    128,   0,   0,   0,   0,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+    128, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 't'
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128, 128, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0, 128,   0,   0,   0,
+      0,   0, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'u'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0, 128, 128,   0,   0,   0,
+      0, 128, 128,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'v'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'w'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'x'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0, 128,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'y'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+    128,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0, 128,   0,   0,   0,
+      0, 128, 128, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // 'z'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128, 128, 128, 128, 128,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '{'
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '|'
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '}'
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0,   0, 128,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    // '~'
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0, 128,   0,   0,   0,   0,   0,   0,
+    128,   0, 128,   0, 128,   0,   0,   0,
+      0,   0,   0, 128,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+} // namespace gfx
@@ -0,0 +1,74 @@
+#include "frame_arena.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace gfx {
+
+static FrameArenaBlock* CreateFrameArenaBlock(size_t capacity) {
+    FrameArenaBlock* block = new FrameArenaBlock();
+    // Cache line aligned so block-relative alignment is also absolute alignment up to 64.
+    block->base = static_cast<u8*>(::operator new(capacity, std::align_val_t(64)));
+    block->capacity = capacity;
+    return block;
+}
+
+static void DestroyFrameArenaBlock(FrameArenaBlock* block) {
+    ::operator delete(block->base, std::align_val_t(64));
+    delete block;
+}
+
+bool InitFrameArena(FrameArena* arena, size_t block_size) {
+    arena->first_block = CreateFrameArenaBlock(block_size);
+    arena->current_block = arena->first_block;
+    arena->offset = 0;
+    arena->used_bytes = 0;
+    return true;
+}
+
+void DestroyFrameArena(FrameArena* arena) {
+    FrameArenaBlock* block = arena->first_block;
+    while (block != nullptr) {
+        FrameArenaBlock* next = block->next;
+        DestroyFrameArenaBlock(block);
+        block = next;
+    }
+    *arena = FrameArena{};
+}
+
+void ResetFrameArena(FrameArena* arena) {
+    arena->current_block = arena->first_block;
+    arena->offset = 0;
+    arena->used_bytes = 0;
+}
+
+void* ArenaAllocate(FrameArena* arena, size_t size, size_t alignment) {
+    while (true) {
+        FrameArenaBlock* block = arena->current_block;
+        size_t aligned_offset = (arena->offset + alignment - 1) & ~(alignment - 1);
+
+        if (aligned_offset + size <= block->capacity) {
+            arena->used_bytes += aligned_offset + size - arena->offset;
+            arena->offset = aligned_offset + size;
+            return block->base + aligned_offset;
+        }
+
+        // Out of room, move on to the next block. Blocks allocated by earlier frames are reused if they are large
+        // enough, otherwise a new one is linked in right after the current block.
+        FrameArenaBlock* next = block->next;
+        if (next == nullptr || next->capacity < size + alignment) {
+            size_t capacity = std::max(FRAME_ARENA_BLOCK_SIZE, size + alignment);
+            gfx_warn("Frame arena grew by {0} bytes.", capacity);
+            FrameArenaBlock* new_block = CreateFrameArenaBlock(capacity);
+            new_block->next = next;
+            block->next = new_block;
+            next = new_block;
+        }
+
+        arena->current_block = next;
+        arena->offset = 0;
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,40 @@
+#pragma once
+#include "types.h"
+#include <cstddef>
+
+namespace gfx {
+
+// Size of a worker's first block. Overflow allocates another block that is kept across resets, so the arena only
+// touches the heap until it has grown to the largest frame seen.
+static constexpr size_t FRAME_ARENA_BLOCK_SIZE = 8 * 1024 * 1024;
+static constexpr size_t FRAME_ARENA_DEFAULT_ALIGNMENT = 16;
+
+struct FrameArenaBlock {
+    u8* base = nullptr;
+    size_t capacity = 0;
+    FrameArenaBlock* next = nullptr;
+};
+
+// Linear (bump) allocator for data that lives until the end of the frame. Not thread-safe, every job worker owns one.
+// Padded to a cache line so workers bumping neighbouring arenas don't false share.
+struct alignas(64) FrameArena {
+    FrameArenaBlock* first_block = nullptr;
+    FrameArenaBlock* current_block = nullptr;
+    size_t offset = 0;
+    // Bytes handed out since the last reset, summed over blocks.
+    size_t used_bytes = 0;
+};
+
+bool InitFrameArena(FrameArena* arena, size_t block_size = FRAME_ARENA_BLOCK_SIZE);
+void DestroyFrameArena(FrameArena* arena);
+// Releases everything at once, blocks are kept for the next frame.
+void ResetFrameArena(FrameArena* arena);
+void* ArenaAllocate(FrameArena* arena, size_t size, size_t alignment = FRAME_ARENA_DEFAULT_ALIGNMENT);
+
+// Uninitialized storage for `count` objects, nothing is ever destructed so T should be trivially destructible.
+template <typename T> T* ArenaAllocateArray(FrameArena* arena, size_t count) {
+    size_t alignment = alignof(T) > FRAME_ARENA_DEFAULT_ALIGNMENT ? alignof(T) : FRAME_ARENA_DEFAULT_ALIGNMENT;
+    return static_cast<T*>(ArenaAllocate(arena, sizeof(T) * count, alignment));
+}
+
+} // namespace gfx
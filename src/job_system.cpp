@@ -0,0 +1,257 @@
+#include "job_system.h"
+#include "logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace gfx {
+
+// Failed steal rounds before an idle worker goes to sleep.
+static constexpr u32 JOB_IDLE_SPIN_COUNT = 64;
+
+static thread_local u32 t_worker_index = 0;
+
+u32 GetCurrentWorkerIndex() { return t_worker_index; }
+
+static void PinThreadToCore(std::thread& thread, u32 core) {
+#ifdef _WIN32
+    SetThreadAffinityMask(thread.native_handle(), (DWORD_PTR)1 << core);
+#else
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpu_set);
+#endif
+}
+
+static void PinCurrentThreadToCore(u32 core) {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core);
+#else
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+#endif
+}
+
+template <typename T> static T* AllocateFromPool(JobPool<T>* pool) {
+    u32 index = pool->next.fetch_add(1, std::memory_order_relaxed);
+    u32 chunk_index = index / JOB_POOL_CHUNK_SIZE;
+    if (chunk_index >= MAX_JOB_POOL_CHUNKS) {
+        gfx_critical("Job pool exhausted, more than {0} allocations in a frame.",
+                     JOB_POOL_CHUNK_SIZE * MAX_JOB_POOL_CHUNKS);
+        std::abort();
+    }
+
+    T* chunk = pool->chunks[chunk_index].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        std::lock_guard<std::mutex> lock(pool->grow_mutex);
+        chunk = pool->chunks[chunk_index].load(std::memory_order_acquire);
+        if (chunk == nullptr) {
+            chunk = new T[JOB_POOL_CHUNK_SIZE];
+            pool->chunks[chunk_index].store(chunk, std::memory_order_release);
+        }
+    }
+    return &chunk[index % JOB_POOL_CHUNK_SIZE];
+}
+
+template <typename T> static void FreePool(JobPool<T>* pool) {
+    for (std::atomic<T*>& chunk : pool->chunks) {
+        delete[] chunk.exchange(nullptr);
+    }
+    pool->next = 0;
+}
+
+static bool PushJob(JobQueue* queue, Job* job) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->tail - queue->head == JOB_QUEUE_CAPACITY)
+        return false;
+    queue->jobs[queue->tail++ & (JOB_QUEUE_CAPACITY - 1)] = job;
+    return true;
+}
+
+static Job* PopJob(JobQueue* queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->tail == queue->head)
+        return nullptr;
+    return queue->jobs[--queue->tail & (JOB_QUEUE_CAPACITY - 1)];
+}
+
+static Job* StealJob(JobQueue* queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->tail == queue->head)
+        return nullptr;
+    return queue->jobs[queue->head++ & (JOB_QUEUE_CAPACITY - 1)];
+}
+
+static void ExecuteJob(JobSystem* job_system, Job* job, u32 worker_index);
+
+static void EnqueueJob(JobSystem* job_system, Job* job, u32 worker_index) {
+    if (!PushJob(&job_system->queues[worker_index], job)) {
+        ExecuteJob(job_system, job, worker_index);
+        return;
+    }
+
+    job_system->queued_job_count.fetch_add(1);
+    if (job_system->sleeping_worker_count.load() > 0) {
+        // Taking the lock orders the notify after a sleeper's predicate check, no lost wake-ups.
+        { std::lock_guard<std::mutex> lock(job_system->sleep_mutex); }
+        job_system->wake_condition.notify_one();
+    }
+}
+
+static Job* FindJob(JobSystem* job_system, u32 worker_index) {
+    Job* job = PopJob(&job_system->queues[worker_index]);
+    if (job == nullptr) {
+        for (u32 i = 1; i < job_system->worker_count; ++i) {
+            u32 victim = (worker_index + i) % job_system->worker_count;
+            job = StealJob(&job_system->queues[victim]);
+            if (job != nullptr)
+                break;
+        }
+    }
+
+    if (job != nullptr) {
+        job_system->queued_job_count.fetch_sub(1);
+    }
+    return job;
+}
+
+static void ExecuteJob(JobSystem* job_system, Job* job, u32 worker_index) {
+    job->function(job, worker_index);
+
+    // Once a continuation is released it may finish and let its waiter recycle this frame's pools, so the job is marked
+    // done up front and every link is read before its decrement. Links not released yet keep the pools alive.
+    JobLink* link = job->continuations;
+    job->is_done.store(true, std::memory_order_release);
+    while (link != nullptr) {
+        Job* continuation = link->job;
+        link = link->next;
+        if (continuation->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            EnqueueJob(job_system, continuation, worker_index);
+        }
+    }
+}
+
+static void WorkerMain(JobSystem* job_system, u32 worker_index) {
+    t_worker_index = worker_index;
+
+    u32 idle_spins = 0;
+    while (!job_system->is_shutting_down.load(std::memory_order_relaxed)) {
+        Job* job = FindJob(job_system, worker_index);
+        if (job != nullptr) {
+            ExecuteJob(job_system, job, worker_index);
+            idle_spins = 0;
+            continue;
+        }
+
+        if (++idle_spins < JOB_IDLE_SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(job_system->sleep_mutex);
+        job_system->sleeping_worker_count.fetch_add(1);
+        job_system->wake_condition.wait(lock, [job_system] {
+            return job_system->queued_job_count.load() > 0 || job_system->is_shutting_down.load();
+        });
+        job_system->sleeping_worker_count.fetch_sub(1);
+        idle_spins = 0;
+    }
+}
+
+bool InitJobSystem(JobSystem* job_system, u32 worker_count, bool pin_workers_to_cores) {
+    if (worker_count == 0) {
+        worker_count = std::thread::hardware_concurrency();
+    }
+    worker_count = std::clamp(worker_count, MIN_JOB_WORKERS, MAX_JOB_WORKERS);
+
+    job_system->worker_count = worker_count;
+    job_system->queues = new JobQueue[worker_count];
+    job_system->is_shutting_down = false;
+    t_worker_index = 0;
+
+    u32 const core_count = std::max(1u, std::thread::hardware_concurrency());
+    if (pin_workers_to_cores) {
+        PinCurrentThreadToCore(0);
+    }
+
+    for (u32 worker_index = 1; worker_index < worker_count; ++worker_index) {
+        job_system->threads[worker_index] = std::thread(WorkerMain, job_system, worker_index);
+        if (pin_workers_to_cores) {
+            PinThreadToCore(job_system->threads[worker_index], worker_index % core_count);
+        }
+    }
+
+    gfx_info("Job system started with {0} workers.", worker_count);
+    return true;
+}
+
+void ShutdownJobSystem(JobSystem* job_system) {
+    if (job_system->queues == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(job_system->sleep_mutex);
+        job_system->is_shutting_down = true;
+    }
+    job_system->wake_condition.notify_all();
+
+    for (u32 worker_index = 1; worker_index < job_system->worker_count; ++worker_index) {
+        job_system->threads[worker_index].join();
+    }
+
+    delete[] job_system->queues;
+    job_system->queues = nullptr;
+    for (u32 i = 0; i < JOB_FRAMES_IN_FLIGHT; ++i) {
+        FreePool(&job_system->job_pools[i]);
+        FreePool(&job_system->link_pools[i]);
+    }
+}
+
+void BeginJobFrame(JobSystem* job_system) {
+    u32 pool_index = (job_system->pool_index + 1) % JOB_FRAMES_IN_FLIGHT;
+    job_system->job_pools[pool_index].next = 0;
+    job_system->link_pools[pool_index].next = 0;
+    job_system->pool_index = pool_index;
+}
+
+Job* AllocateJob(JobSystem* job_system) {
+    Job* job = AllocateFromPool(&job_system->job_pools[job_system->pool_index]);
+    job->function = nullptr;
+    job->pending_dependencies.store(0, std::memory_order_relaxed);
+    job->is_done.store(false, std::memory_order_relaxed);
+    job->continuations = nullptr;
+    return job;
+}
+
+void AddJobDependency(JobSystem* job_system, Job* before, Job* after) {
+    JobLink* link = AllocateFromPool(&job_system->link_pools[job_system->pool_index]);
+    link->job = after;
+    link->next = before->continuations;
+    before->continuations = link;
+    after->pending_dependencies.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SubmitJob(JobSystem* job_system, Job* job) { EnqueueJob(job_system, job, GetCurrentWorkerIndex()); }
+
+void WaitForJob(JobSystem* job_system, Job* job) {
+    u32 const worker_index = GetCurrentWorkerIndex();
+    while (!job->is_done.load(std::memory_order_acquire)) {
+        Job* other = FindJob(job_system, worker_index);
+        if (other != nullptr) {
+            ExecuteJob(job_system, other, worker_index);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,144 @@
+#pragma once
+#include "types.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace gfx {
+
+static constexpr u32 MIN_JOB_WORKERS = 2;
+static constexpr u32 MAX_JOB_WORKERS = 64;
+// Lambda captures are stored in the job itself, no allocation per job.
+static constexpr size_t JOB_PAYLOAD_SIZE = 128;
+// Power of two, a full queue runs the job inline instead.
+static constexpr u32 JOB_QUEUE_CAPACITY = 4096;
+// Jobs and dependency links come from pools that are reset every frame. Chunks are allocated on first use, so the pool
+// warms up over the first few frames and then stays put.
+static constexpr u32 JOB_POOL_CHUNK_SIZE = 1024;
+static constexpr u32 MAX_JOB_POOL_CHUNKS = 64;
+// Jobs of a frame may still run while the next frame builds its graph (pipelined rendering), so pools are
+// double-buffered and BeginJobFrame only recycles the older one.
+static constexpr u32 JOB_FRAMES_IN_FLIGHT = 2;
+
+struct Job;
+using JobFunction = void (*)(Job* job, u32 worker_index);
+
+struct JobLink {
+    Job* job;
+    JobLink* next;
+};
+
+struct Job {
+    JobFunction function = nullptr;
+    alignas(16) u8 payload[JOB_PAYLOAD_SIZE];
+    // Dependencies that haven't finished yet, the job is queued when this reaches zero.
+    std::atomic<s32> pending_dependencies = 0;
+    std::atomic<bool> is_done = false;
+    // Jobs that depend on this one.
+    JobLink* continuations = nullptr;
+};
+
+// Per-worker deque, the owner pushes and pops at the back and thieves take from the front.
+struct JobQueue {
+    std::mutex mutex;
+    Job* jobs[JOB_QUEUE_CAPACITY];
+    u32 head = 0;
+    u32 tail = 0;
+};
+
+template <typename T> struct JobPool {
+    std::atomic<T*> chunks[MAX_JOB_POOL_CHUNKS] = {};
+    std::atomic<u32> next = 0;
+    std::mutex grow_mutex;
+};
+
+struct JobSystem {
+    // Worker 0 is the thread that called InitJobSystem, it runs jobs while waiting on them.
+    u32 worker_count = 0;
+    std::thread threads[MAX_JOB_WORKERS];
+    JobQueue* queues = nullptr;
+
+    JobPool<Job> job_pools[JOB_FRAMES_IN_FLIGHT];
+    JobPool<JobLink> link_pools[JOB_FRAMES_IN_FLIGHT];
+    u32 pool_index = 0;
+
+    std::atomic<u32> queued_job_count = 0;
+    std::atomic<u32> sleeping_worker_count = 0;
+    std::atomic<bool> is_shutting_down = false;
+    std::mutex sleep_mutex;
+    std::condition_variable wake_condition;
+};
+
+// worker_count = 0 picks the hardware thread count, the result is clamped to [MIN_JOB_WORKERS, MAX_JOB_WORKERS].
+bool InitJobSystem(JobSystem* job_system, u32 worker_count = 0, bool pin_workers_to_cores = false);
+void ShutdownJobSystem(JobSystem* job_system);
+
+// Recycles every job and link allocated JOB_FRAMES_IN_FLIGHT frames ago, those must have finished.
+void BeginJobFrame(JobSystem* job_system);
+
+// Index of the calling worker, 0 for the thread that initialized the job system.
+u32 GetCurrentWorkerIndex();
+
+Job* AllocateJob(JobSystem* job_system);
+// `after` won't start until `before` has finished. The whole graph has to be built before any of it is submitted.
+void AddJobDependency(JobSystem* job_system, Job* before, Job* after);
+// Only jobs without dependencies are submitted, the rest are queued as their last dependency finishes.
+void SubmitJob(JobSystem* job_system, Job* job);
+// Runs other jobs on the calling thread until `job` is done.
+void WaitForJob(JobSystem* job_system, Job* job);
+
+// `function(worker_index)` runs on whichever worker picks the job up.
+template <typename F> Job* CreateJob(JobSystem* job_system, F const& function) {
+    static_assert(sizeof(F) <= JOB_PAYLOAD_SIZE, "Job capture too large");
+    static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                  "Job captures must be trivially copyable");
+
+    Job* job = AllocateJob(job_system);
+    new (job->payload) F(function);
+    job->function = [](Job* job, u32 worker_index) {
+        (*std::launder(reinterpret_cast<F*>(job->payload)))(worker_index);
+    };
+    return job;
+}
+
+// An empty job, used to join or fan out groups of jobs.
+inline Job* CreateEmptyJob(JobSystem* job_system) {
+    return CreateJob(job_system, [](u32) {});
+}
+
+// Jobs of a parallel-for, depend on `begin` to gate the group and on `end` to wait for it.
+struct JobGroup {
+    Job* begin;
+    Job* end;
+};
+
+// Splits [0, count) into batches of `batch_size`, `function(first, last, worker_index)` runs once per batch. Every job
+// gets its own copy of `function`, so the group may outlive the caller's scope.
+template <typename F>
+JobGroup CreateParallelFor(JobSystem* job_system, size_t count, size_t batch_size, F const& function) {
+    JobGroup group = {CreateEmptyJob(job_system), CreateEmptyJob(job_system)};
+    for (size_t first = 0; first < count; first += batch_size) {
+        size_t last = std::min(first + batch_size, count);
+        Job* job =
+            CreateJob(job_system, [function, first, last](u32 worker_index) { function(first, last, worker_index); });
+        AddJobDependency(job_system, group.begin, job);
+        AddJobDependency(job_system, job, group.end);
+    }
+    if (count == 0) {
+        AddJobDependency(job_system, group.begin, group.end);
+    }
+    return group;
+}
+
+// Runs a parallel-for to completion.
+template <typename F> void ParallelFor(JobSystem* job_system, size_t count, size_t batch_size, F const& function) {
+    JobGroup group = CreateParallelFor(job_system, count, batch_size, function);
+    SubmitJob(job_system, group.begin);
+    WaitForJob(job_system, group.end);
+}
+
+} // namespace gfx
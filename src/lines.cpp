@@ -0,0 +1,178 @@
+#include "lines.h"
+#include "renderer.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace gfx {
+
+// Parameters [t0, t1] of the segment's part inside the raster-space rect [0, width] x [0, height] (Liang-Barsky).
+// False when nothing is inside.
+static bool ClipLineToRect(vec2f const& p0, vec2f const& p1, f32 width, f32 height, f32& t0, f32& t1) {
+    vec2f const delta = p1 - p0;
+    f32 const directions[4] = {-delta.x, delta.x, -delta.y, delta.y};
+    f32 const distances[4] = {p0.x, width - p0.x, p0.y, height - p0.y};
+
+    t0 = 0.0f;
+    t1 = 1.0f;
+    for (u32 side = 0; side < 4; ++side) {
+        if (directions[side] == 0.0f) {
+            // Parallel to this side, either all inside or all outside of it.
+            if (distances[side] < 0.0f)
+                return false;
+            continue;
+        }
+        f32 const t = distances[side] / directions[side];
+        if (directions[side] < 0.0f) {
+            t0 = std::max(t0, t);
+        } else {
+            t1 = std::min(t1, t);
+        }
+    }
+    return t0 <= t1;
+}
+
+__forceinline static bool IsLineDepthVisible(DepthBuffer const* depth_buffer, size_t x, size_t y, f32 depth) {
+    u32 const line_depth = EncodeDepth(depth_buffer->format, depth * (1.0f + LINE_DEPTH_BIAS));
+    DepthTile const& tile = depth_buffer->tiles[GetDepthTileIndex(depth_buffer, x, y)];
+    if (tile.state == DepthTileState::Decompressed) {
+        return line_depth >= LoadDepth(depth_buffer, x, y);
+    }
+    // Clear tiles read as 0, everything passes.
+    return line_depth >= EncodeDepth(depth_buffer->format, GetCompressedDepth(tile, x, y));
+}
+
+// Expects the segment clipped to the buffer. Pixels are picked where the line crosses the center of each column
+// (x-major) or row (y-major), the end pixels are the ones holding the end points.
+template <bool depth_test>
+static void RasterizeLine(Renderer* renderer, vec2f p0, vec2f p1, f32 depth0, f32 depth1, u32 color) {
+    bool const is_x_major = std::abs(p1.x - p0.x) >= std::abs(p1.y - p0.y);
+    if (is_x_major ? p0.x > p1.x : p0.y > p1.y) {
+        std::swap(p0, p1);
+        std::swap(depth0, depth1);
+    }
+
+    f32 const major0 = is_x_major ? p0.x : p0.y;
+    f32 const major1 = is_x_major ? p1.x : p1.y;
+    f32 const minor0 = is_x_major ? p0.y : p0.x;
+    f32 const minor1 = is_x_major ? p1.y : p1.x;
+    s32 const major_max = (s32)(is_x_major ? renderer->buffer_width : renderer->buffer_height) - 1;
+    s32 const minor_max = (s32)(is_x_major ? renderer->buffer_height : renderer->buffer_width) - 1;
+
+    // Clipping leaves end points on the far edges of the buffer, those belong to the last column or row.
+    s32 const major_first = std::clamp((s32)std::floor(major0), 0, major_max);
+    s32 const major_last = std::clamp((s32)std::floor(major1), 0, major_max);
+    s32 const minor_first = std::clamp((s32)std::floor(minor0), 0, minor_max);
+    s32 const minor_last = std::clamp((s32)std::floor(minor1), 0, minor_max);
+
+    // A line within one row or column is a span.
+    if (!depth_test && minor_first == minor_last) {
+        if (is_x_major) {
+            DrawHorizontalLine(renderer, major_first, major_last + 1, minor_first, color);
+        } else {
+            DrawVerticalLine(renderer, minor_first, major_first, major_last + 1, color);
+        }
+        return;
+    }
+
+    f32 const major_length = major1 - major0;
+    f32 const minor_slope = major_length > 0.0f ? (minor1 - minor0) / major_length : 0.0f;
+    f32 const depth_slope = major_length > 0.0f ? (depth1 - depth0) / major_length : 0.0f;
+
+    DepthBuffer const* depth_buffer = &renderer->depth_buffer;
+    u32* color_buffer = renderer->color_buffer;
+    size_t const stride = renderer->color_buffer_stride;
+    for (s32 major = major_first; major <= major_last; ++major) {
+        // The end columns sample at the end points when those don't reach the column's center.
+        f32 const step = std::clamp((f32)major + 0.5f, major0, major1) - major0;
+        s32 minor = minor_first;
+        if (minor_first != minor_last) {
+            minor = std::clamp((s32)std::floor(minor0 + step * minor_slope), 0, minor_max);
+        }
+
+        size_t const x = (size_t)(is_x_major ? major : minor);
+        size_t const y = (size_t)(is_x_major ? minor : major);
+        if constexpr (depth_test) {
+            if (!IsLineDepthVisible(depth_buffer, x, y, depth0 + step * depth_slope))
+                continue;
+        }
+        color_buffer[y * stride + x] = color;
+    }
+}
+
+void DrawHorizontalLine(Renderer* renderer, s32 x0, s32 x1, s32 y, u32 color) {
+    if (y < 0 || y >= (s32)renderer->buffer_height)
+        return;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, (s32)renderer->buffer_width);
+    if (x0 >= x1)
+        return;
+
+    u32* row = renderer->color_buffer + (size_t)y * renderer->color_buffer_stride;
+    std::fill(row + x0, row + x1, color);
+}
+
+void DrawVerticalLine(Renderer* renderer, s32 x, s32 y0, s32 y1, u32 color) {
+    if (x < 0 || x >= (s32)renderer->buffer_width)
+        return;
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, (s32)renderer->buffer_height);
+
+    size_t const stride = renderer->color_buffer_stride;
+    u32* pixel = renderer->color_buffer + (size_t)y0 * stride + x;
+    for (s32 y = y0; y < y1; ++y, pixel += stride) {
+        *pixel = color;
+    }
+}
+
+void DrawLine(Renderer* renderer, vec2f const& p0, vec2f const& p1, u32 color) {
+    f32 t0, t1;
+    if (!ClipLineToRect(p0, p1, renderer->fBuffer_width, renderer->fBuffer_heigth, t0, t1))
+        return;
+
+    vec2f const delta = p1 - p0;
+    RasterizeLine<false>(renderer, p0 + delta * t0, p0 + delta * t1, 0.0f, 0.0f, color);
+}
+
+// Same mapping as SetupTrianglePositions, top-left origin.
+__forceinline static vec2f GetRasterPosition(Renderer const* renderer, vec4f const& clip) {
+    vec2f const ndc = vec2f(clip) / clip.w;
+    vec2f const pretransform = vec2f((ndc.x + 1.0f) * 0.5f, 1.0f - (ndc.y + 1.0f) * 0.5f);
+    return pretransform * vec2f(renderer->fBuffer_width, renderer->fBuffer_heigth);
+}
+
+void DrawLine3D(Renderer* renderer, vec4f const& p0_clip, vec4f const& p1_clip, u32 color, bool depth_test) {
+    // Triangles with a vertex below w = 1 are dropped, lines are cut there instead.
+    if (!(p0_clip.w >= 1.0f || p1_clip.w >= 1.0f))
+        return;
+
+    vec4f v0 = p0_clip;
+    vec4f v1 = p1_clip;
+    if (v0.w < 1.0f) {
+        v0 += (v1 - v0) * ((1.0f - v0.w) / (v1.w - v0.w));
+    } else if (v1.w < 1.0f) {
+        v1 += (v0 - v1) * ((1.0f - v1.w) / (v0.w - v1.w));
+    }
+
+    vec2f const p0 = GetRasterPosition(renderer, v0);
+    vec2f const p1 = GetRasterPosition(renderer, v1);
+    f32 t0, t1;
+    if (!ClipLineToRect(p0, p1, renderer->fBuffer_width, renderer->fBuffer_heigth, t0, t1))
+        return;
+
+    // 1/w is linear in raster space, so it's clipped and stepped like the position.
+    f32 const depth0 = 1.0f / v0.w;
+    f32 const depth1 = 1.0f / v1.w;
+    vec2f const delta = p1 - p0;
+    vec2f const clipped0 = p0 + delta * t0;
+    vec2f const clipped1 = p0 + delta * t1;
+    f32 const clipped_depth0 = depth0 + (depth1 - depth0) * t0;
+    f32 const clipped_depth1 = depth0 + (depth1 - depth0) * t1;
+    if (depth_test) {
+        RasterizeLine<true>(renderer, clipped0, clipped1, clipped_depth0, clipped_depth1, color);
+    } else {
+        RasterizeLine<false>(renderer, clipped0, clipped1, clipped_depth0, clipped_depth1, color);
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,26 @@
+#pragma once
+#include "types.h"
+
+namespace gfx {
+
+struct Renderer;
+
+// Line drawing for wireframes and debug geometry. Lines are immediate-mode like PutPixel and clipped to the render
+// resolution. Axis-aligned runs are filled as spans, everything else is stepped one pixel per column or row along the
+// major axis. Both end pixels are drawn.
+
+// Depth tested lines are nudged towards the camera by this fraction of their 1/w, so the edges of triangles already in
+// the depth buffer win against their own surface.
+static constexpr f32 LINE_DEPTH_BIAS = 1.0f / 256.0f;
+
+// Pixels [x0, x1) of row y.
+void DrawHorizontalLine(Renderer* renderer, s32 x0, s32 x1, s32 y, u32 color);
+// Pixels [y0, y1) of column x.
+void DrawVerticalLine(Renderer* renderer, s32 x, s32 y0, s32 y1, u32 color);
+// Raster-space line between two points.
+void DrawLine(Renderer* renderer, vec2f const& p0, vec2f const& p1, u32 color);
+// Clip-space line, clipped at w = 1 like triangles. With `depth_test` a pixel is drawn when the line's 1/w is
+// GREATER_EQUAL the depth buffer's, lines never write depth so they don't hide each other or decompress depth tiles.
+void DrawLine3D(Renderer* renderer, vec4f const& p0_clip, vec4f const& p1_clip, u32 color, bool depth_test = true);
+
+} // namespace gfx
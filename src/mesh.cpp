@@ -1,5 +1,7 @@
 #include "mesh.h"
 #include "logger.h"
+#include "mesh_lod.h"
+#include <algorithm>
 
 bool gfx::ImportMeshFromSceneFile(Mesh* mesh, char const* file_path, size_t mesh_index) {
     Assimp::Importer importer;
@@ -13,6 +15,10 @@ bool gfx::ImportMeshFromSceneFile(Mesh* mesh, char const* file_path, size_t mesh
 
     aiMesh* assimp_mesh = scene->mMeshes[mesh_index];
 
+    // A re-import replaces quantized storage too, QuantizeMesh can run again afterwards.
+    mesh->is_quantized = false;
+    mesh->quantized = QuantizedMesh{};
+
 		mesh->vertices.resize(assimp_mesh->mNumVertices);
     mesh->normals.resize(assimp_mesh->mNumVertices);
     mesh->triangles.resize(assimp_mesh->mNumFaces);
@@ -26,5 +32,81 @@ bool gfx::ImportMeshFromSceneFile(Mesh* mesh, char const* file_path, size_t mesh
         mesh->triangles[face_index].indices[2] = assimp_mesh->mFaces[face_index].mIndices[2];
     }
 
+    ComputeMeshBounds(mesh);
+    GenerateMeshLods(mesh);
+    ++mesh->version;
     return true;
 }
+
+void gfx::ComputeMeshBounds(Mesh* mesh) {
+    mesh->bounds = AABB{};
+    for (vec3f const& v : mesh->vertices) {
+        ExpandAABB(mesh->bounds, v);
+    }
+}
+
+void gfx::QuantizeMesh(Mesh* mesh) {
+    size_t const vertex_count = mesh->vertices.size();
+    if (mesh->is_quantized || vertex_count == 0)
+        return;
+
+    QuantizedMesh& quantized = mesh->quantized;
+    vec3f const extent = mesh->bounds.max - mesh->bounds.min;
+    quantized.position_offset = mesh->bounds.min;
+    quantized.position_scale = extent / 65535.0f;
+    // Flat axes quantize to 0.
+    vec3f const quantize_scale = vec3f(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f,
+                                       extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+                                       extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+
+    bool const has_normals = mesh->normals.size() == vertex_count;
+    quantized.vertices.resize(vertex_count);
+    for (size_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index) {
+        vec3f const position = (mesh->vertices[vertex_index] - mesh->bounds.min) * quantize_scale;
+        QuantizedVertex& vertex = quantized.vertices[vertex_index];
+        for (u32 axis = 0; axis < 3; ++axis) {
+            vertex.position[axis] = (u16)std::clamp(position[axis] + 0.5f, 0.0f, 65535.0f);
+        }
+        EncodeOctahedralNormal(has_normals ? mesh->normals[vertex_index] : vec3f(0.0f, 0.0f, 1.0f), vertex.normal);
+    }
+
+    bool const has_16bit_indices = vertex_count <= 65536;
+    quantized.lod_indices16.clear();
+    quantized.lod_indices32.clear();
+    for (u32 lod = 0; lod <= (u32)mesh->lods.size(); ++lod) {
+        std::vector<Face>& triangles = lod == 0 ? mesh->triangles : mesh->lods[lod - 1].triangles;
+        if (has_16bit_indices) {
+            std::vector<u16>& indices = quantized.lod_indices16.emplace_back();
+            indices.reserve(triangles.size() * 3);
+            for (Face const& face : triangles) {
+                indices.insert(indices.end(), {(u16)face.indices[0], (u16)face.indices[1], (u16)face.indices[2]});
+            }
+        } else {
+            std::vector<u32>& indices = quantized.lod_indices32.emplace_back();
+            indices.reserve(triangles.size() * 3);
+            for (Face const& face : triangles) {
+                indices.insert(indices.end(), {face.indices[0], face.indices[1], face.indices[2]});
+            }
+        }
+        std::vector<Face>().swap(triangles);
+    }
+
+    std::vector<vec3f>().swap(mesh->vertices);
+    std::vector<vec3f>().swap(mesh->normals);
+    mesh->is_quantized = true;
+    // Positions moved by up to half a quantization step.
+    ++mesh->version;
+}
+
+void gfx::EncodeOctahedralNormal(vec3f const& normal, u8 encoded[2]) {
+    // Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper one.
+    f32 const length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    vec2f octahedron = length > 0.0f ? vec2f(normal.x, normal.y) / length : vec2f(0.0f);
+    if (length > 0.0f && normal.z < 0.0f) {
+        octahedron = vec2f((1.0f - std::abs(octahedron.y)) * (octahedron.x >= 0.0f ? 1.0f : -1.0f),
+                           (1.0f - std::abs(octahedron.x)) * (octahedron.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    for (u32 axis = 0; axis < 2; ++axis) {
+        encoded[axis] = (u8)std::clamp((octahedron[axis] * 0.5f + 0.5f) * 255.0f + 0.5f, 0.0f, 255.0f);
+    }
+}
@@ -3,6 +3,7 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <cfloat>
 #include <vector>
 
 namespace gfx {
@@ -11,12 +12,99 @@ struct Face {
     u32 indices[3];
 };
 
+// Axis-aligned bounding box, empty (inverted) by default.
+struct AABB {
+    vec3f min = vec3f(FLT_MAX);
+    vec3f max = vec3f(-FLT_MAX);
+};
+
+// Simplified index buffer over the same vertices as the full resolution mesh.
+struct MeshLod {
+    std::vector<Face> triangles;
+    // Approximate object-space deviation from the full resolution mesh.
+    f32 error = 0.0f;
+};
+
+// 16 bits per position axis over the mesh bounds and an octahedral normal in 2x8 bits, 8 bytes instead of the 24 of
+// the float arrays.
+struct QuantizedVertex {
+    u16 position[3];
+    u8 normal[2];
+};
+static_assert(sizeof(QuantizedVertex) == 8);
+
+// Compact vertex and index data of a mesh, built by QuantizeMesh.
+struct QuantizedMesh {
+    std::vector<QuantizedVertex> vertices;
+    // position = position_offset + quantized position * position_scale
+    vec3f position_offset = vec3f(0.0f);
+    vec3f position_scale = vec3f(0.0f);
+    // Triangle lists, one per LOD with LOD 0 first. 16-bit when the mesh has at most 65536 vertices, lod_indices32 is
+    // used otherwise.
+    std::vector<std::vector<u16>> lod_indices16;
+    std::vector<std::vector<u32>> lod_indices32;
+};
+
 struct Mesh {
     std::vector<vec3f> vertices;
 		std::vector<Face> triangles;
     std::vector<vec3f> normals;
+    // Object-space bounds, computed at import.
+    AABB bounds;
+    // LOD 0 is `triangles`, lods[i] is LOD i + 1, each coarser than the previous one.
+    std::vector<MeshLod> lods;
+    // Bump after editing the mesh (and recomputing its bounds), scenes redraw every instance of it.
+    u32 version = 0;
+    // Set by QuantizeMesh. `vertices`, `normals` and the triangles of every LOD are released, `quantized` holds them.
+    bool is_quantized = false;
+    QuantizedMesh quantized;
 };
 
 bool ImportMeshFromSceneFile(Mesh* mesh, char const* file_path, size_t mesh_index = 0);
+void ComputeMeshBounds(Mesh* mesh);
+// Switches the mesh to QuantizedMesh storage, call once it's complete (bounds and LODs). Editing it afterwards means
+// importing it again.
+void QuantizeMesh(Mesh* mesh);
+
+// Octahedral mapping of a unit vector to two bytes.
+void EncodeOctahedralNormal(vec3f const& normal, u8 encoded[2]);
+
+__forceinline size_t GetMeshVertexCount(Mesh const* mesh) {
+    return mesh->is_quantized ? mesh->quantized.vertices.size() : mesh->vertices.size();
+}
+
+__forceinline vec3f GetMeshVertexPosition(Mesh const* mesh, u32 index) {
+    if (!mesh->is_quantized)
+        return mesh->vertices[index];
+
+    u16 const* position = mesh->quantized.vertices[index].position;
+    return mesh->quantized.position_offset +
+           vec3f((f32)position[0], (f32)position[1], (f32)position[2]) * mesh->quantized.position_scale;
+}
+
+__forceinline void ExpandAABB(AABB& aabb, vec3f const& p) {
+    aabb.min = glm::min(aabb.min, p);
+    aabb.max = glm::max(aabb.max, p);
+}
+
+__forceinline void ExpandAABB(AABB& aabb, AABB const& other) {
+    aabb.min = glm::min(aabb.min, other.min);
+    aabb.max = glm::max(aabb.max, other.max);
+}
+
+__forceinline f32 GetAABBSurfaceArea(AABB const& aabb) {
+    vec3f d = aabb.max - aabb.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// Bounds of an AABB after an affine transform (Arvo's method, center/extent form).
+__forceinline AABB TransformAABB(AABB const& aabb, glm::mat4 const& m) {
+    vec3f center = (aabb.min + aabb.max) * 0.5f;
+    vec3f extent = (aabb.max - aabb.min) * 0.5f;
+    vec3f new_center = vec3f(m * vec4f(center, 1.0f));
+    vec3f new_extent = glm::abs(vec3f(m[0])) * extent.x + glm::abs(vec3f(m[1])) * extent.y +
+                       glm::abs(vec3f(m[2])) * extent.z;
+    return AABB{new_center - new_extent, new_center + new_extent};
+}
 
 } // namespace gfx
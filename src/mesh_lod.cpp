@@ -0,0 +1,350 @@
+#include "mesh_lod.h"
+#include "logger.h"
+#include <algorithm>
+#include <queue>
+
+namespace gfx {
+
+// Boundary edges get a penalty plane perpendicular to the surface so open borders don't shrink.
+static constexpr f64 BOUNDARY_QUADRIC_WEIGHT = 10.0;
+// A level that removed less than this fraction of triangles means the simplifier got stuck.
+static constexpr f64 MIN_LOD_REDUCTION = 0.1;
+
+// Symmetric 4x4 matrix (Garland & Heckbert), only the upper triangle is stored.
+struct Quadric {
+    f64 a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    f64 b2 = 0.0, bc = 0.0, bd = 0.0;
+    f64 c2 = 0.0, cd = 0.0;
+    f64 d2 = 0.0;
+};
+
+struct EdgeCollapse {
+    f64 cost;
+    // `from` is removed and its faces are re-pointed to `to`.
+    u32 from, to;
+    // Vertex versions at the time the collapse was evaluated, stale entries are skipped when popped.
+    u32 from_version, to_version;
+
+    bool operator>(EdgeCollapse const& other) const { return cost > other.cost; }
+};
+
+struct SimplifyState {
+    std::vector<vec3f> const* positions = nullptr;
+    std::vector<Quadric> quadrics;
+    std::vector<u32> versions;
+    std::vector<u8> is_vertex_removed;
+    std::vector<std::vector<u32>> vertex_faces;
+    std::vector<Face> faces;
+    std::vector<u8> is_face_removed;
+    size_t live_face_count = 0;
+    std::priority_queue<EdgeCollapse, std::vector<EdgeCollapse>, std::greater<EdgeCollapse>> heap;
+};
+
+__forceinline Quadric MakePlaneQuadric(f64 a, f64 b, f64 c, f64 d, f64 weight) {
+    Quadric q;
+    q.a2 = weight * a * a, q.ab = weight * a * b, q.ac = weight * a * c, q.ad = weight * a * d;
+    q.b2 = weight * b * b, q.bc = weight * b * c, q.bd = weight * b * d;
+    q.c2 = weight * c * c, q.cd = weight * c * d;
+    q.d2 = weight * d * d;
+    return q;
+}
+
+__forceinline void AddQuadric(Quadric& q, Quadric const& other) {
+    q.a2 += other.a2, q.ab += other.ab, q.ac += other.ac, q.ad += other.ad;
+    q.b2 += other.b2, q.bc += other.bc, q.bd += other.bd;
+    q.c2 += other.c2, q.cd += other.cd;
+    q.d2 += other.d2;
+}
+
+// v^T * Q * v with v = (p, 1), sum of squared distances to the accumulated planes.
+__forceinline f64 EvaluateQuadric(Quadric const& q, vec3f const& p) {
+    f64 x = p.x, y = p.y, z = p.z;
+    f64 error = q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x + q.b2 * y * y +
+                2.0 * q.bc * y * z + 2.0 * q.bd * y + q.c2 * z * z + 2.0 * q.cd * z + q.d2;
+    return std::max(error, 0.0);
+}
+
+__forceinline Quadric MakePlaneQuadric(vec3f const& normal, vec3f const& point, f64 weight) {
+    return MakePlaneQuadric(normal.x, normal.y, normal.z, -(f64)glm::dot(normal, point), weight);
+}
+
+__forceinline bool FaceContains(Face const& face, u32 index) {
+    return face.indices[0] == index || face.indices[1] == index || face.indices[2] == index;
+}
+
+// Maps every vertex to the first vertex sharing its position. Importers split vertices along normal/UV seams, the
+// simplifier has to see those as one vertex or the seams would tear open.
+static std::vector<u32> WeldVerticesByPosition(std::vector<vec3f> const& positions) {
+    std::vector<u32> order(positions.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = (u32)i;
+    }
+
+    auto less = [&positions](u32 a, u32 b) {
+        vec3f const& pa = positions[a];
+        vec3f const& pb = positions[b];
+        if (pa.x != pb.x)
+            return pa.x < pb.x;
+        if (pa.y != pb.y)
+            return pa.y < pb.y;
+        if (pa.z != pb.z)
+            return pa.z < pb.z;
+        return a < b;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    std::vector<u32> weld(positions.size());
+    size_t group_start = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (positions[order[i]] != positions[order[group_start]]) {
+            group_start = i;
+        }
+        weld[order[i]] = order[group_start];
+    }
+    return weld;
+}
+
+static void PushEdgeCollapse(SimplifyState& state, u32 a, u32 b) {
+    std::vector<vec3f> const& positions = *state.positions;
+    Quadric q = state.quadrics[a];
+    AddQuadric(q, state.quadrics[b]);
+
+    f64 cost_a_to_b = EvaluateQuadric(q, positions[b]);
+    f64 cost_b_to_a = EvaluateQuadric(q, positions[a]);
+
+    if (cost_a_to_b <= cost_b_to_a) {
+        state.heap.push({cost_a_to_b, a, b, state.versions[a], state.versions[b]});
+    } else {
+        state.heap.push({cost_b_to_a, b, a, state.versions[b], state.versions[a]});
+    }
+}
+
+// Rejects collapses that would flip the orientation of any surviving face around `from`.
+static bool CanCollapse(SimplifyState const& state, u32 from, u32 to) {
+    std::vector<vec3f> const& positions = *state.positions;
+    for (u32 face_index : state.vertex_faces[from]) {
+        if (state.is_face_removed[face_index])
+            continue;
+
+        Face const& face = state.faces[face_index];
+        if (FaceContains(face, to))
+            continue;
+
+        vec3f p[3];
+        vec3f p_new[3];
+        for (u32 i = 0; i < 3; ++i) {
+            p[i] = positions[face.indices[i]];
+            p_new[i] = face.indices[i] == from ? positions[to] : p[i];
+        }
+
+        vec3f n_old = glm::cross(p[1] - p[0], p[2] - p[0]);
+        vec3f n_new = glm::cross(p_new[1] - p_new[0], p_new[2] - p_new[0]);
+        if (glm::dot(n_old, n_new) <= 0.0f)
+            return false;
+    }
+    return true;
+}
+
+static void ApplyCollapse(SimplifyState& state, u32 from, u32 to) {
+    for (u32 face_index : state.vertex_faces[from]) {
+        if (state.is_face_removed[face_index])
+            continue;
+
+        Face& face = state.faces[face_index];
+        if (FaceContains(face, to)) {
+            // Edge face, degenerates.
+            state.is_face_removed[face_index] = 1;
+            --state.live_face_count;
+            continue;
+        }
+
+        for (u32& index : face.indices) {
+            if (index == from)
+                index = to;
+        }
+        state.vertex_faces[to].push_back(face_index);
+    }
+
+    state.vertex_faces[from].clear();
+    state.is_vertex_removed[from] = 1;
+    AddQuadric(state.quadrics[to], state.quadrics[from]);
+    ++state.versions[to];
+
+    // Drop dead faces from `to` and re-evaluate every edge around it.
+    std::vector<u32>& to_faces = state.vertex_faces[to];
+    to_faces.erase(std::remove_if(to_faces.begin(), to_faces.end(),
+                                  [&state](u32 face_index) { return state.is_face_removed[face_index] != 0; }),
+                   to_faces.end());
+
+    std::vector<u32> neighbors;
+    for (u32 face_index : to_faces) {
+        for (u32 index : state.faces[face_index].indices) {
+            if (index != to)
+                neighbors.push_back(index);
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+    for (u32 neighbor : neighbors) {
+        PushEdgeCollapse(state, to, neighbor);
+    }
+}
+
+static void InitSimplifyState(SimplifyState& state, Mesh const* mesh) {
+    size_t const vertex_count = mesh->vertices.size();
+    std::vector<vec3f> const& positions = mesh->vertices;
+    std::vector<u32> weld = WeldVerticesByPosition(positions);
+
+    state.positions = &positions;
+    state.quadrics.assign(vertex_count, Quadric{});
+    state.versions.assign(vertex_count, 0);
+    state.is_vertex_removed.assign(vertex_count, 0);
+    state.vertex_faces.assign(vertex_count, {});
+    state.faces.clear();
+    state.faces.reserve(mesh->triangles.size());
+
+    for (Face const& source : mesh->triangles) {
+        Face face = {{weld[source.indices[0]], weld[source.indices[1]], weld[source.indices[2]]}};
+        if (face.indices[0] == face.indices[1] || face.indices[1] == face.indices[2] ||
+            face.indices[2] == face.indices[0])
+            continue;
+
+        vec3f const& p0 = positions[face.indices[0]];
+        vec3f normal = glm::cross(positions[face.indices[1]] - p0, positions[face.indices[2]] - p0);
+        f32 normal_length = glm::length(normal);
+        if (normal_length <= 0.0f)
+            continue;
+        normal /= normal_length;
+
+        Quadric q = MakePlaneQuadric(normal, p0, 1.0);
+        u32 face_index = (u32)state.faces.size();
+        for (u32 index : face.indices) {
+            AddQuadric(state.quadrics[index], q);
+            state.vertex_faces[index].push_back(face_index);
+        }
+        state.faces.push_back(face);
+    }
+
+    state.is_face_removed.assign(state.faces.size(), 0);
+    state.live_face_count = state.faces.size();
+
+    // Gather every directed edge as (min, max, face), identical keys are shared by adjacent faces.
+    struct EdgeRef {
+        u32 v0, v1;
+        u32 face_index;
+    };
+    std::vector<EdgeRef> edges;
+    edges.reserve(state.faces.size() * 3);
+    for (u32 face_index = 0; face_index < (u32)state.faces.size(); ++face_index) {
+        Face const& face = state.faces[face_index];
+        for (u32 i = 0; i < 3; ++i) {
+            u32 a = face.indices[i];
+            u32 b = face.indices[(i + 1) % 3];
+            edges.push_back({std::min(a, b), std::max(a, b), face_index});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](EdgeRef const& a, EdgeRef const& b) {
+        return a.v0 != b.v0 ? a.v0 < b.v0 : a.v1 < b.v1;
+    });
+
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].v0 == edges[i].v0 && edges[j].v1 == edges[i].v1) {
+            ++j;
+        }
+
+        EdgeRef const& edge = edges[i];
+        if (j - i == 1) {
+            // Boundary edge
+            Face const& face = state.faces[edge.face_index];
+            vec3f const& p0 = positions[face.indices[0]];
+            vec3f face_normal =
+                glm::normalize(glm::cross(positions[face.indices[1]] - p0, positions[face.indices[2]] - p0));
+            vec3f edge_direction = positions[edge.v1] - positions[edge.v0];
+            vec3f plane_normal = glm::cross(edge_direction, face_normal);
+            f32 plane_normal_length = glm::length(plane_normal);
+            if (plane_normal_length > 0.0f) {
+                Quadric q = MakePlaneQuadric(plane_normal / plane_normal_length, positions[edge.v0],
+                                             BOUNDARY_QUADRIC_WEIGHT);
+                AddQuadric(state.quadrics[edge.v0], q);
+                AddQuadric(state.quadrics[edge.v1], q);
+            }
+        }
+        i = j;
+    }
+
+    // Quadrics are final, seed the heap.
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (i > 0 && edges[i].v0 == edges[i - 1].v0 && edges[i].v1 == edges[i - 1].v1)
+            continue;
+        PushEdgeCollapse(state, edges[i].v0, edges[i].v1);
+    }
+}
+
+void GenerateMeshLods(Mesh* mesh, u32 max_lod_count) {
+    mesh->lods.clear();
+    if (mesh->triangles.size() < MIN_LOD_TRIANGLE_COUNT * 2 || max_lod_count <= 1)
+        return;
+
+    SimplifyState state;
+    InitSimplifyState(state, mesh);
+
+    // Every LOD continues from the previous one, so the chain is built in one pass.
+    f64 max_collapse_error = 0.0;
+    size_t previous_count = mesh->triangles.size();
+
+    for (u32 lod = 1; lod < max_lod_count; ++lod) {
+        size_t target_count = previous_count / 2;
+        if (target_count < MIN_LOD_TRIANGLE_COUNT)
+            break;
+
+        while (state.live_face_count > target_count && !state.heap.empty()) {
+            EdgeCollapse collapse = state.heap.top();
+            state.heap.pop();
+
+            if (state.is_vertex_removed[collapse.from] || state.is_vertex_removed[collapse.to])
+                continue;
+            if (state.versions[collapse.from] != collapse.from_version ||
+                state.versions[collapse.to] != collapse.to_version)
+                continue;
+            if (!CanCollapse(state, collapse.from, collapse.to))
+                continue;
+
+            ApplyCollapse(state, collapse.from, collapse.to);
+            max_collapse_error = std::max(max_collapse_error, collapse.cost);
+        }
+
+        if ((f64)state.live_face_count > (f64)previous_count * (1.0 - MIN_LOD_REDUCTION))
+            break;
+
+        MeshLod& mesh_lod = mesh->lods.emplace_back();
+        mesh_lod.triangles.reserve(state.live_face_count);
+        for (size_t face_index = 0; face_index < state.faces.size(); ++face_index) {
+            if (!state.is_face_removed[face_index]) {
+                mesh_lod.triangles.push_back(state.faces[face_index]);
+            }
+        }
+        // Quadric error is a sum of squared plane distances.
+        mesh_lod.error = (f32)std::sqrt(max_collapse_error);
+        previous_count = state.live_face_count;
+    }
+
+    gfx_info("Generated {0} LODs, {1} -> {2} triangles", mesh->lods.size(), mesh->triangles.size(), previous_count);
+}
+
+u32 SelectMeshLod(Mesh const* mesh, f32 error_scale, f32 distance, f32 projection_scale, f32 max_pixel_error) {
+    if (distance <= 0.0f)
+        return 0;
+
+    f32 pixels_per_unit = projection_scale * error_scale / distance;
+    u32 selected = 0;
+    for (u32 lod = 1; lod < GetMeshLodCount(mesh); ++lod) {
+        if (GetMeshLodError(mesh, lod) * pixels_per_unit > max_pixel_error)
+            break;
+        selected = lod;
+    }
+    return selected;
+}
+
+} // namespace gfx
@@ -0,0 +1,56 @@
+#pragma once
+#include "mesh.h"
+#include "types.h"
+#include <vector>
+
+namespace gfx {
+
+static constexpr u32 MAX_MESH_LODS = 6;
+// Stop generating LODs once a level would have fewer triangles than this.
+static constexpr size_t MIN_LOD_TRIANGLE_COUNT = 16;
+
+// Builds mesh->lods with quadric error metric edge collapses, each LOD has roughly half the triangles of the previous
+// one. Collapses only move vertices onto existing ones so every LOD indexes the original vertex buffer.
+void GenerateMeshLods(Mesh* mesh, u32 max_lod_count = MAX_MESH_LODS);
+
+__forceinline u32 GetMeshLodCount(Mesh const* mesh) { return 1 + (u32)mesh->lods.size(); }
+
+__forceinline std::vector<Face> const& GetMeshLodTriangles(Mesh const* mesh, u32 lod) {
+    return lod == 0 ? mesh->triangles : mesh->lods[lod - 1].triangles;
+}
+
+// Calls fn(index0, index1, index2) for every triangle of a LOD, whichever index format the mesh stores.
+template <typename Fn>
+__forceinline void ForEachMeshLodTriangle(Mesh const* mesh, u32 lod, Fn&& fn) {
+    if (!mesh->is_quantized) {
+        for (Face const& face : GetMeshLodTriangles(mesh, lod)) {
+            fn(face.indices[0], face.indices[1], face.indices[2]);
+        }
+    } else if (!mesh->quantized.lod_indices16.empty()) {
+        std::vector<u16> const& indices = mesh->quantized.lod_indices16[lod];
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            fn((u32)indices[i], (u32)indices[i + 1], (u32)indices[i + 2]);
+        }
+    } else {
+        std::vector<u32> const& indices = mesh->quantized.lod_indices32[lod];
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            fn(indices[i], indices[i + 1], indices[i + 2]);
+        }
+    }
+}
+
+__forceinline f32 GetMeshLodError(Mesh const* mesh, u32 lod) { return lod == 0 ? 0.0f : mesh->lods[lod - 1].error; }
+
+// Vertical pixels covered by one world unit at distance 1 for a perspective projection.
+__forceinline f32 GetProjectionScale(f32 fov_y, f32 viewport_height) {
+    return viewport_height / (2.0f * std::tan(fov_y * 0.5f));
+}
+
+/*
+ * Picks the coarsest LOD whose error projects to at most `max_pixel_error` pixels.
+ * error_scale: object to world scale of the instance (largest axis)
+ * distance: world-space distance from the camera to the mesh
+ * */
+u32 SelectMeshLod(Mesh const* mesh, f32 error_scale, f32 distance, f32 projection_scale, f32 max_pixel_error);
+
+} // namespace gfx
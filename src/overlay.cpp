@@ -0,0 +1,83 @@
+#include "overlay.h"
+#include "renderer.h"
+#include <algorithm>
+
+namespace gfx {
+
+// Alpha is ignored, overlays never read the color buffer (see overlay.h).
+__forceinline static u32 GetOpaqueColor(u32 color) { return color | 0xFF000000; }
+
+vec2i MeasureOverlayText(char const* text) {
+    s32 columns = 0;
+    s32 max_columns = 0;
+    s32 lines = 1;
+    for (char const* c = text; *c != '\0'; ++c) {
+        if (*c == '\n') {
+            columns = 0;
+            ++lines;
+            continue;
+        }
+        max_columns = std::max(max_columns, ++columns);
+    }
+    return {max_columns * (s32)FONT_ADVANCE, lines * (s32)FONT_LINE_HEIGHT};
+}
+
+void DrawOverlayText(Renderer* renderer, s32 x, s32 y, char const* text, u32 color) {
+    s32 const width = (s32)renderer->buffer_width;
+    s32 const height = (s32)renderer->buffer_height;
+    u32 const opaque_color = GetOpaqueColor(color);
+
+    s32 pen_x = x;
+    s32 pen_y = y;
+    for (char const* c = text; *c != '\0'; ++c) {
+        if (*c == '\n') {
+            pen_x = x;
+            pen_y += (s32)FONT_LINE_HEIGHT;
+            continue;
+        }
+
+        s32 const glyph_x = pen_x;
+        pen_x += (s32)FONT_ADVANCE;
+        u32 const glyph = (u32)(u8)*c - FONT_FIRST_CHAR;
+        // Spaces have no coverage.
+        if (glyph == 0 || glyph >= FONT_GLYPH_COUNT)
+            continue;
+        if (glyph_x >= width || glyph_x + (s32)FONT_GLYPH_WIDTH <= 0 || pen_y >= height ||
+            pen_y + (s32)FONT_GLYPH_HEIGHT <= 0)
+            continue;
+
+        u8 const* cell = FONT_ATLAS + (size_t)glyph * FONT_CELL_WIDTH * FONT_CELL_HEIGHT;
+        s32 const row_begin = std::max(0, -pen_y);
+        s32 const row_end = std::min((s32)FONT_GLYPH_HEIGHT, height - pen_y);
+        s32 const column_begin = std::max(0, -glyph_x);
+        s32 const column_end = std::min((s32)FONT_GLYPH_WIDTH, width - glyph_x);
+
+        // The atlas is 1-bit, any coverage is a solid pixel and the rest are left alone.
+        for (s32 row = row_begin; row < row_end; ++row) {
+            u8 const* coverage = cell + row * FONT_CELL_WIDTH;
+            u32* pixels = renderer->color_buffer + (size_t)(pen_y + row) * renderer->color_buffer_stride + glyph_x;
+            for (s32 column = column_begin; column < column_end; ++column) {
+                if (coverage[column] != 0) {
+                    pixels[column] = opaque_color;
+                }
+            }
+        }
+    }
+}
+
+void DrawOverlayRect(Renderer* renderer, s32 x, s32 y, s32 w, s32 h, u32 color) {
+    s32 const x0 = std::max(x, 0);
+    s32 const y0 = std::max(y, 0);
+    s32 const x1 = std::min(x + w, (s32)renderer->buffer_width);
+    s32 const y1 = std::min(y + h, (s32)renderer->buffer_height);
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    u32 const opaque_color = GetOpaqueColor(color);
+    for (s32 row = y0; row < y1; ++row) {
+        u32* pixels = renderer->color_buffer + (size_t)row * renderer->color_buffer_stride;
+        std::fill(pixels + x0, pixels + x1, opaque_color);
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,32 @@
+#pragma once
+#include "font_atlas.h"
+#include "types.h"
+#include <fmt/format.h>
+#include <utility>
+
+namespace gfx {
+
+struct Renderer;
+
+// Debug overlays drawn straight into the color buffer with the baked font in font_atlas.h. They are immediate-mode like
+// PutPixel: draw them after the scene, never while pipelined. Headless renderers can draw them too. The color buffer
+// may be the write-only locked texture, so overlays only store opaque pixels and never read it back: a color's alpha is
+// ignored. Everything is clipped to the render resolution.
+
+// Formats into a fixed-size buffer, the result is truncated rather than allocated. Returns `buffer`.
+template <size_t N, typename... Args>
+char const* FormatText(char (&buffer)[N], fmt::format_string<Args...> format, Args&&... args) {
+    static_assert(N > 0);
+    auto const result = fmt::format_to_n(buffer, N - 1, format, std::forward<Args>(args)...);
+    *result.out = '\0';
+    return buffer;
+}
+
+// Pixel size of the text's bounding box, '\n' starts a new line.
+vec2i MeasureOverlayText(char const* text);
+// Top-left of the first glyph at (x, y). Characters without a glyph advance like a space.
+void DrawOverlayText(Renderer* renderer, s32 x, s32 y, char const* text, u32 color);
+// Solid rect, an opaque background keeps text readable over the scene.
+void DrawOverlayRect(Renderer* renderer, s32 x, s32 y, s32 w, s32 h, u32 color);
+
+} // namespace gfx
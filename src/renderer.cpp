@@ -1,5 +1,12 @@
 #include "renderer.h"
+#include "lines.h"
 #include "logger.h"
+#include "mesh_lod.h"
+#include "overlay.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GFX_SSE2 1
+#endif
 
 namespace gfx {
 
@@ -14,46 +21,22 @@ void InitImGui(SDL_Window* wnd, SDL_Renderer* renderer) {
     ImGui::StyleColorsDark();
 }
 
-bool InitRenderer(SDL_Window* window, Renderer* renderer) {
-    // Create SDL Renderer
-    renderer->sdl_renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
-
-    if (renderer->sdl_renderer == nullptr) {
-        gfx_error(SDL_GetError());
-        return false;
-    }
-
-    // Create SDL Texture (framebuffer)
-    s32 w, h;
-    SDL_GetWindowSize(window, &w, &h);
-
-    // Going to ignore high DpI stuff for now.
-    renderer->framebuffer =
-        SDL_CreateTexture(renderer->sdl_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
-
-    if (renderer->framebuffer == nullptr) {
-        gfx_error(SDL_GetError());
-        return false;
-    }
-
+// Everything but the SDL objects: CPU-side buffers, tiles, job system and frame slots for a w x h target.
+static bool InitRenderTargets(Renderer* renderer, RendererSettings const& settings, s32 w, s32 h) {
     renderer->color_buffer_pitch = sizeof(u32) * w;
+    renderer->color_buffer_stride = w;
+    renderer->aspect_ratio = (f32)w / (f32)h;
 
-    // Allocate color buffer (CpU)
-    renderer->color_buffer = new u32[w * h];
-
-    renderer->w_buffer = new f32[w * h];
-    renderer->clear_w_buffer = new f32[w * h];
+    // Allocate color buffer (CpU), also used when the framebuffer can't be locked.
+    renderer->cpu_color_buffer = new u32[w * h];
+    renderer->color_buffer = renderer->cpu_color_buffer;
 
-    // Clear W buffer is where all values are 0.0f.
-    // We W buffer for the visibility problem to avoid computing the actual depth value (camera space Z value of a given
-    // pixel)
-    for (size_t y = 0; y < h; ++y) {
-        for (size_t x = 0; x < w; ++x) {
-            renderer->clear_w_buffer[y * w + x] = 0.0f;
-        }
+    // Depth is 1/w rather than the camera space Z value of a given pixel, it interpolates linearly in screen-space.
+    if (!InitDepthBuffer(&renderer->depth_buffer, w, h, settings.depth_format, settings.compress_depth)) {
+        return false;
     }
 
-    if (renderer->color_buffer == nullptr) {
+    if (renderer->cpu_color_buffer == nullptr) {
         gfx_error("Color buffer could not be allocated.");
         return false;
     }
@@ -64,12 +47,88 @@ bool InitRenderer(SDL_Window* window, Renderer* renderer) {
     renderer->fBuffer_heigth = (f32)h;
     renderer->buffer_size_in_pixels = w * h;
     renderer->color_buffer_size_in_bytes = sizeof(u32) * (size_t)w * (size_t)h;
-    renderer->w_buffer_size_in_bytes = sizeof(f32) * (size_t)w * (size_t)h;
+    renderer->max_buffer_width = w;
+    renderer->max_buffer_height = h;
+
+    if (renderer->is_resolution_dynamic) {
+        renderer->upscaled_color_buffer = new u32[w * h];
+    }
 
     GenerateL0Tiles(renderer, L0_TILE_SIZE);
+
+    if (!InitJobSystem(&renderer->job_system, settings.worker_count, settings.pin_workers_to_cores)) {
+        gfx_error("Job system could not be started.");
+        return false;
+    }
+
+    u32 const frame_slot_count = settings.pipelined ? FRAME_SLOT_COUNT : 1;
+    for (u32 i = 0; i < frame_slot_count; ++i) {
+        FrameSlot& slot = renderer->frame_slots[i];
+        slot.binning_contexts.resize(renderer->job_system.worker_count);
+        slot.frame_arenas.resize(renderer->job_system.worker_count);
+        for (FrameArena& arena : slot.frame_arenas) {
+            if (!InitFrameArena(&arena)) {
+                gfx_error("Frame arena could not be allocated.");
+                return false;
+            }
+        }
+    }
     return true;
 }
 
+bool InitRenderer(SDL_Window* window, Renderer* renderer, RendererSettings const& settings) {
+    renderer->present_mode = settings.present_mode;
+    renderer->async_present = settings.async_present;
+    renderer->is_pipelined = settings.pipelined;
+    renderer->is_incremental = settings.incremental;
+    renderer->is_resolution_dynamic = settings.dynamic_resolution && !settings.pipelined;
+    if (settings.dynamic_resolution && settings.pipelined) {
+        gfx_warn("Dynamic resolution is not available when pipelined, rendering at the window size.");
+    }
+
+    // Create SDL Renderer, asynchronous present doesn't block on vsync.
+    u32 renderer_flags = settings.async_present ? 0 : SDL_RENDERER_PRESENTVSYNC;
+    renderer->sdl_renderer = SDL_CreateRenderer(window, -1, renderer_flags);
+
+    if (renderer->sdl_renderer == nullptr) {
+        gfx_error(SDL_GetError());
+        return false;
+    }
+
+    // Create SDL Texture (framebuffer)
+    s32 w, h;
+    SDL_GetWindowSize(window, &w, &h);
+
+    // Going to ignore high DpI stuff for now.
+    renderer->framebuffer_count = (settings.async_present || settings.pipelined) ? 2 : 1;
+    for (u32 i = 0; i < renderer->framebuffer_count; ++i) {
+        renderer->framebuffers[i] =
+            SDL_CreateTexture(renderer->sdl_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+
+        if (renderer->framebuffers[i] == nullptr) {
+            gfx_error(SDL_GetError());
+            return false;
+        }
+    }
+    renderer->framebuffer = renderer->framebuffers[0];
+
+    return InitRenderTargets(renderer, settings, w, h);
+}
+
+bool InitHeadlessRenderer(Renderer* renderer, size_t width, size_t height, RendererSettings const& settings) {
+    // Frames are read back from cpu_color_buffer and the depth buffer right after drawing, nothing is presented. Draws
+    // rasterize immediately and every frame is a full redraw at the initial size.
+    RendererSettings headless_settings = settings;
+    headless_settings.pipelined = false;
+    headless_settings.dynamic_resolution = false;
+
+    renderer->present_mode = PresentMode::Copy;
+    renderer->framebuffer_count = 0;
+    return InitRenderTargets(renderer, headless_settings, (s32)width, (s32)height);
+}
+
+static FrameSlot* GetCurrentFrameSlot(Renderer* renderer) { return &renderer->frame_slots[renderer->frame_slot_index]; }
+
 Corner GetTrivialRejectCorner(f32 A, f32 B) {
     if (A == 0.0f || B == 0.0f) {
         return Corner::BottomLeft;
@@ -93,6 +152,21 @@ Corner GetTrivialRejectCorner(f32 A, f32 B) {
     }
 }
 
+// Tile labels sit just inside the tile's top-left corner, clear of the grid lines.
+static constexpr s32 TILE_LABEL_OFFSET = 3;
+
+static void DrawTileGridLines(Renderer* renderer) {
+    constexpr u32 GRID_COLOR = RGB(50, 50, 125);
+    s32 const width = (s32)renderer->buffer_width;
+    s32 const height = (s32)renderer->buffer_height;
+    size_t const pitch = renderer->l0_tile_count_pitch;
+    for (size_t tile = 0; tile < pitch; ++tile) {
+        s32 const position = (s32)(tile * L0_TILE_SIZE);
+        DrawHorizontalLine(renderer, 0, width, position, GRID_COLOR);
+        DrawVerticalLine(renderer, position, 0, height, GRID_COLOR);
+    }
+}
+
 u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
     // These can be pre-computed when triangle is constructed. (Also should be recomputed when triangle is transformed)
     f32 A01, B01, A12, B12, A20, B20 = 0.0f;
@@ -105,20 +179,11 @@ u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
     Corner E12_TR_corner = GetTrivialRejectCorner(A12, B12);
     Corner E20_TR_corner = GetTrivialRejectCorner(A20, B20);
 
-    ImGui::Begin("Dummy", 0,
-                 ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
-                     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs);
-    ImGui::SetWindowSize(ImVec2(renderer->fBuffer_width, renderer->fBuffer_heigth));
-    ImGui::SetWindowPos(ImVec2(0.0f, 0.0f));
-    ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(0.0f, 0.0f));
-    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0.0f, 0.0f));
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
-
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-
+    char label[32];
     for (Tile const& tile : renderer->l0_tiles) {
 
-        ImVec2 tile_text_pos = {(f32)tile.orig_x0, (f32)tile.orig_y0};
+        s32 const label_x = (s32)tile.orig_x0 + TILE_LABEL_OFFSET;
+        s32 const label_y = (s32)tile.orig_y0 + TILE_LABEL_OFFSET;
 
         // @TODO: clean tis shi up
         // Edge 01 -- TRC = Trivial reject corner
@@ -126,8 +191,7 @@ u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
         f32 E01_TRC_value = A01 * (E01_TRC_pos.y - triangle->vtx_pos0.y) + B01 * (E01_TRC_pos.x - triangle->vtx_pos0.x);
 
         if (E01_TRC_value > 0.0f) {
-            draw_list->AddText(tile_text_pos, IM_COL32(255, 0, 0, 255),
-                               fmt::format("Tile {0} (TR)", tile.index).c_str());
+            DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0} (TR)", tile.index), RGB(255, 0, 0));
             continue;
         }
 
@@ -136,8 +200,7 @@ u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
         f32 E12_TRC_value = A12 * (E12_TRC_pos.y - triangle->vtx_pos1.y) + B12 * (E12_TRC_pos.x - triangle->vtx_pos1.x);
 
         if (E12_TRC_value > 0.0f) {
-            draw_list->AddText(tile_text_pos, IM_COL32(255, 0, 0, 255),
-                               fmt::format("Tile {0} (TR)", tile.index).c_str());
+            DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0} (TR)", tile.index), RGB(255, 0, 0));
             continue;
         }
 
@@ -145,8 +208,7 @@ u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
         f32 E20_TRC_value = A20 * (E20_TRC_pos.y - triangle->vtx_pos2.y) + B20 * (E20_TRC_pos.x - triangle->vtx_pos2.x);
 
         if (E20_TRC_value > 0.0f) {
-            draw_list->AddText(tile_text_pos, IM_COL32(255, 0, 0, 255),
-                               fmt::format("Tile {0} (TR)", tile.index).c_str());
+            DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0} (TR)", tile.index), RGB(255, 0, 0));
             continue;
         }
 
@@ -162,33 +224,14 @@ u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle) {
         f32 E20_TAC_value = A20 * (E20_TAC_pos.y - triangle->vtx_pos2.y) + B20 * (E20_TAC_pos.x - triangle->vtx_pos2.x);
 
         if (E01_TAC_value < 0.0f && E12_TAC_value < 0.0f && E20_TAC_value < 0.0f) {
-            draw_list->AddText(tile_text_pos, IM_COL32(0, 255, 0, 255),
-                               fmt::format("Tile {0} (TA)", tile.index).c_str());
+            DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0} (TA)", tile.index), RGB(0, 255, 0));
             continue;
         }
 
-        draw_list->AddText(tile_text_pos, IM_COL32_WHITE, fmt::format("Tile {0}", tile.index).c_str());
-    }
-
-    constexpr u32 GRID_COLOR = IM_COL32(50, 50, 125, 255);
-    size_t const pitch = renderer->l0_tile_count_pitch;
-
-    for (size_t tile_y = 0; tile_y < pitch; ++tile_y) {
-        // Horizontal lines
-        ImVec2 horizontal_start = {0.0f, static_cast<f32>(tile_y * L0_TILE_SIZE)};
-        ImVec2 horizontal_end = {renderer->fBuffer_width, horizontal_start.y};
-        draw_list->AddLine(horizontal_start, horizontal_end, GRID_COLOR);
-
-        // Vertical lines + Tile ID text
-        for (size_t tile_x = 0; tile_x < pitch; ++tile_x) {
-            ImVec2 vertical_start = {static_cast<f32>(tile_x * L0_TILE_SIZE), 0.0f};
-            ImVec2 vertical_end = {vertical_start.x, renderer->fBuffer_heigth};
-            draw_list->AddLine(vertical_start, vertical_end, GRID_COLOR);
-        }
+        DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0}", tile.index), RGB(255, 255, 255));
     }
-    ImGui::PopStyleVar(3);
 
-    ImGui::End();
+    DrawTileGridLines(renderer);
     return 0;
 }
 
@@ -198,11 +241,12 @@ void GenerateL0Tiles(Renderer* renderer, size_t tile_size) {
     renderer->l0_tile_count = renderer->l0_tile_count_pitch * renderer->l0_tile_count_pitch;
 
     renderer->l0_tiles.resize(renderer->l0_tile_count);
+    renderer->dirty_l0_tiles.assign(renderer->l0_tile_count, 0);
 
     for (size_t tile_y = 0; tile_y < renderer->l0_tile_count_pitch; ++tile_y) {
         for (size_t tile_x = 0; tile_x < renderer->l0_tile_count_pitch; ++tile_x) {
             u32 index = tile_y * renderer->l0_tile_count_pitch + tile_x;
-            u64 id = (1 << index);
+            u64 id = ((u64)1 << index);
 
             Tile& t = renderer->l0_tiles[index];
             t.index = index;
@@ -226,136 +270,741 @@ void GenerateL0Tiles(Renderer* renderer, size_t tile_size) {
 }
 
 void DrawTileGrid(Renderer* renderer) {
+    DrawTileGridLines(renderer);
 
-    ImGui::Begin("Dummy", 0,
-                 ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
-                     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs);
-    ImGui::SetWindowSize(ImVec2(renderer->fBuffer_width, renderer->fBuffer_heigth));
-    ImGui::SetWindowPos(ImVec2(0.0f, 0.0f));
-
-    constexpr u32 GRID_COLOR = IM_COL32(50, 50, 125, 255);
+    char label[32];
     size_t const pitch = renderer->l0_tile_count_pitch;
-
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
     for (size_t tile_y = 0; tile_y < pitch; ++tile_y) {
-        // Horizontal lines
-        ImVec2 horizontal_start = {0.0f, static_cast<f32>(tile_y * L0_TILE_SIZE)};
-        ImVec2 horizontal_end = {renderer->fBuffer_width, horizontal_start.y};
-        draw_list->AddLine(horizontal_start, horizontal_end, GRID_COLOR);
-
-        // Vertical lines + Tile ID text
         for (size_t tile_x = 0; tile_x < pitch; ++tile_x) {
-            ImVec2 vertical_start = {static_cast<f32>(tile_x * L0_TILE_SIZE), 0.0f};
-            ImVec2 vertical_end = {vertical_start.x, renderer->fBuffer_heigth};
-            draw_list->AddLine(vertical_start, vertical_end, GRID_COLOR);
-
             u32 index = tile_y * pitch + tile_x;
-            ImVec2 text_loc = {vertical_start.x + 4.0f, horizontal_start.y};
-            draw_list->AddText(text_loc, IM_COL32_WHITE, fmt::format("Tile {0}", (index)).c_str());
+            s32 const label_x = (s32)(tile_x * L0_TILE_SIZE) + TILE_LABEL_OFFSET;
+            s32 const label_y = (s32)(tile_y * L0_TILE_SIZE) + TILE_LABEL_OFFSET;
+            DrawOverlayText(renderer, label_x, label_y, FormatText(label, "Tile {0}", index), RGB(255, 255, 255));
+        }
+    }
+}
+
+bool AcquireColorBuffer(Renderer* renderer) {
+    // Below the window size the frame goes into the CPU buffer, Present upscales it into the texture.
+    if (renderer->present_mode == PresentMode::LockedTexture && !IsUpscaling(renderer) &&
+        !renderer->is_framebuffer_locked) {
+        void* pixels = nullptr;
+        s32 pitch = 0;
+        if (SDL_LockTexture(renderer->framebuffer, nullptr, &pixels, &pitch) == 0) {
+            renderer->color_buffer = static_cast<u32*>(pixels);
+            renderer->color_buffer_pitch = pitch;
+            renderer->color_buffer_stride = (size_t)pitch / sizeof(u32);
+            renderer->is_framebuffer_locked = true;
+            return true;
         }
+
+        gfx_error("Could not lock the framebuffer, falling back to copy present: {0}", SDL_GetError());
+        renderer->present_mode = PresentMode::Copy;
+    }
+
+    if (renderer->present_mode == PresentMode::Copy || IsUpscaling(renderer)) {
+        renderer->color_buffer = renderer->cpu_color_buffer;
+        renderer->color_buffer_pitch = (s32)(sizeof(u32) * renderer->max_buffer_width);
+        renderer->color_buffer_stride = renderer->max_buffer_width;
+    }
+    return true;
+}
+
+static void ResetBinningContexts(FrameSlot* slot) {
+    for (BinningContext& context : slot->binning_contexts) {
+        std::fill(std::begin(context.tile_bins), std::end(context.tile_bins), nullptr);
     }
-    ImGui::End();
+    slot->draw_count = 0;
 }
 
+void SetFrameUpdate(Renderer* renderer, FrameUpdate update) {
+    std::fill(renderer->dirty_l0_tiles.begin(), renderer->dirty_l0_tiles.end(), 0);
+    if (!renderer->is_incremental || renderer->is_pipelined || !renderer->has_previous_frame) {
+        update = FrameUpdate::Full;
+    }
+    if (update == FrameUpdate::DirtyTiles && renderer->present_mode != PresentMode::Copy && !IsUpscaling(renderer)) {
+        update = FrameUpdate::Full;
+    }
+    renderer->frame_update = update;
+}
+
+bool SetRenderResolution(Renderer* renderer, size_t width, size_t height) {
+    if (!renderer->is_resolution_dynamic)
+        return false;
+
+    width = std::clamp<size_t>(width, 1, renderer->max_buffer_width);
+    height = std::clamp<size_t>(height, 1, renderer->max_buffer_height);
+    if (width == renderer->buffer_width && height == renderer->buffer_height)
+        return true;
+
+    if (!ResizeDepthBuffer(&renderer->depth_buffer, width, height))
+        return false;
+
+    renderer->buffer_width = width;
+    renderer->buffer_height = height;
+    renderer->fBuffer_width = (f32)width;
+    renderer->fBuffer_heigth = (f32)height;
+    renderer->buffer_size_in_pixels = width * height;
+    renderer->color_buffer_size_in_bytes = sizeof(u32) * width * height;
+    // Same tile size, fewer tiles. The tile vectors were sized for the window and don't reallocate.
+    GenerateL0Tiles(renderer, L0_TILE_SIZE);
+
+    // Output pixel centers mapped onto the render resolution, clamped at the edges.
+    f32 const scale_x = (f32)width / (f32)renderer->max_buffer_width;
+    renderer->upscale_taps.resize(renderer->max_buffer_width);
+    for (size_t x = 0; x < renderer->max_buffer_width; ++x) {
+        f32 const source_x = std::max(((f32)x + 0.5f) * scale_x - 0.5f, 0.0f);
+        UpscaleTap& tap = renderer->upscale_taps[x];
+        tap.x0 = (u32)source_x;
+        tap.x1 = (u32)std::min<size_t>(tap.x0 + 1, width - 1);
+        tap.weight = (u32)((source_x - (f32)tap.x0) * (f32)UPSCALE_WEIGHT_ONE + 0.5f);
+    }
+
+    // Color and depth of the last frame are at the old resolution.
+    renderer->has_previous_frame = false;
+    return true;
+}
+
+bool SetRenderScale(Renderer* renderer, f32 scale) {
+    size_t const width = (size_t)std::lround((f32)renderer->max_buffer_width * scale);
+    size_t const height = (size_t)std::lround((f32)renderer->max_buffer_height * scale);
+    return SetRenderResolution(renderer, width, height);
+}
+
+void MarkDirtyRect(Renderer* renderer, vec2f const& min, vec2f const& max) {
+    if (max.x < 0.0f || max.y < 0.0f || min.x >= renderer->fBuffer_width || min.y >= renderer->fBuffer_heigth)
+        return;
+
+    s32 const last_tile_x = (s32)((renderer->buffer_width - 1) / L0_TILE_SIZE);
+    s32 const last_tile_y = (s32)((renderer->buffer_height - 1) / L0_TILE_SIZE);
+    s32 tile_x0 = std::clamp((s32)min.x / (s32)L0_TILE_SIZE, 0, last_tile_x);
+    s32 tile_y0 = std::clamp((s32)min.y / (s32)L0_TILE_SIZE, 0, last_tile_y);
+    s32 tile_x1 = std::clamp((s32)max.x / (s32)L0_TILE_SIZE, 0, last_tile_x);
+    s32 tile_y1 = std::clamp((s32)max.y / (s32)L0_TILE_SIZE, 0, last_tile_y);
+
+    size_t const pitch = renderer->l0_tile_count_pitch;
+    for (s32 tile_y = tile_y0; tile_y <= tile_y1; ++tile_y) {
+        for (s32 tile_x = tile_x0; tile_x <= tile_x1; ++tile_x) {
+            renderer->dirty_l0_tiles[tile_y * pitch + tile_x] = 1;
+        }
+    }
+}
+
+// Whether this frame rasterizes the tile at all.
+__forceinline static bool IsL0TileRedrawn(Renderer const* renderer, size_t tile_index) {
+    switch (renderer->frame_update) {
+    case FrameUpdate::Full:
+        return true;
+    case FrameUpdate::DirtyTiles:
+        return renderer->dirty_l0_tiles[tile_index] != 0;
+    default:
+        return false;
+    }
+}
+
+static void ClearL0Tile(Renderer* renderer, size_t tile_index);
+
 void ClearBuffers(Renderer* renderer) {
-    std::memset(renderer->color_buffer, 0x00, renderer->color_buffer_size_in_bytes);
-    std::memcpy(renderer->w_buffer, renderer->clear_w_buffer, renderer->w_buffer_size_in_bytes);
+    // Start of a new frame. When pipelined the previous frame may still be rasterizing, but it only touches the other
+    // slot and job pool, this slot's frame was finished in the last Present.
+    BeginJobFrame(&renderer->job_system);
+    FrameSlot* slot = GetCurrentFrameSlot(renderer);
+    for (FrameArena& arena : slot->frame_arenas) {
+        ResetFrameArena(&arena);
+    }
+    ResetBinningContexts(slot);
+
+    // The raster jobs clear each tile right before rasterizing it.
+    if (renderer->is_pipelined || renderer->frame_update == FrameUpdate::Reuse)
+        return;
+
+    AcquireColorBuffer(renderer);
+
+    if (renderer->frame_update == FrameUpdate::DirtyTiles) {
+        auto clear_dirty_tiles = [renderer](size_t first_tile, size_t last_tile, u32) {
+            for (size_t tile_index = first_tile; tile_index < last_tile; ++tile_index) {
+                if (renderer->dirty_l0_tiles[tile_index] != 0) {
+                    ClearL0Tile(renderer, tile_index);
+                }
+            }
+        };
+        ParallelFor(&renderer->job_system, renderer->l0_tile_count, 1, clear_dirty_tiles);
+        return;
+    }
+
+    // Clear in bands of L0 tile rows. The locked texture's pitch may be wider than the buffer, clear row by row.
+    size_t const width = renderer->buffer_width;
+    auto clear_rows = [renderer, width](size_t first_row, size_t last_row, u32) {
+        for (size_t y = first_row; y < last_row; ++y) {
+            std::memset(renderer->color_buffer + y * renderer->color_buffer_stride, 0x00, width * sizeof(u32));
+        }
+        ClearDepthTiles(&renderer->depth_buffer, 0, first_row, width, last_row);
+    };
+    ParallelFor(&renderer->job_system, renderer->buffer_height, L0_TILE_SIZE, clear_rows);
 }
 
-void Present(Renderer* renderer) {
-    SDL_UpdateTexture(renderer->framebuffer, nullptr, renderer->color_buffer, renderer->color_buffer_pitch);
+#ifdef GFX_SSE2
+// a + (b - a) * weight per 16-bit channel, weight out of UPSCALE_WEIGHT_ONE.
+__forceinline static __m128i LerpChannels(__m128i a, __m128i b, __m128i weight) {
+    __m128i const delta = _mm_mullo_epi16(_mm_sub_epi16(b, a), weight);
+    return _mm_add_epi16(a, _mm_srai_epi16(delta, UPSCALE_WEIGHT_SHIFT));
+}
+#endif
+
+__forceinline static u32 LerpPixel(u32 a, u32 b, u32 weight) {
+    u32 result = 0;
+    for (u32 shift = 0; shift < 32; shift += 8) {
+        s32 const channel_a = (s32)((a >> shift) & 0xFF);
+        s32 const channel_b = (s32)((b >> shift) & 0xFF);
+        s32 const channel = channel_a + (((channel_b - channel_a) * (s32)weight) >> UPSCALE_WEIGHT_SHIFT);
+        result |= (u32)channel << shift;
+    }
+    return result;
+}
+
+// One framebuffer row, bilinear from the render resolution image in cpu_color_buffer.
+static void UpscaleRow(Renderer const* renderer, size_t y, u32* target_row) {
+    f32 const scale_y = renderer->fBuffer_heigth / (f32)renderer->max_buffer_height;
+    f32 const source_y = std::max(((f32)y + 0.5f) * scale_y - 0.5f, 0.0f);
+    size_t const y0 = (size_t)source_y;
+    size_t const y1 = std::min(y0 + 1, renderer->buffer_height - 1);
+    u32 const weight_y = (u32)((source_y - (f32)y0) * (f32)UPSCALE_WEIGHT_ONE + 0.5f);
+
+    u32 const* row0 = renderer->cpu_color_buffer + y0 * renderer->max_buffer_width;
+    u32 const* row1 = renderer->cpu_color_buffer + y1 * renderer->max_buffer_width;
+    UpscaleTap const* taps = renderer->upscale_taps.data();
+    size_t const width = renderer->max_buffer_width;
+    size_t x = 0;
+
+#ifdef GFX_SSE2
+    // Two output pixels per iteration, channels widened to 16 bits. Weights are 7 bits so the products fit.
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const weight_y_lanes = _mm_set1_epi16((s16)weight_y);
+    for (; x + 2 <= width; x += 2) {
+        UpscaleTap const& tap0 = taps[x];
+        UpscaleTap const& tap1 = taps[x + 1];
+        __m128i const top_left = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (s32)row0[tap1.x0], (s32)row0[tap0.x0]), zero);
+        __m128i const top_right = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (s32)row0[tap1.x1], (s32)row0[tap0.x1]), zero);
+        __m128i const bottom_left =
+            _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (s32)row1[tap1.x0], (s32)row1[tap0.x0]), zero);
+        __m128i const bottom_right =
+            _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (s32)row1[tap1.x1], (s32)row1[tap0.x1]), zero);
+        __m128i const weight_x = _mm_set_epi16((s16)tap1.weight, (s16)tap1.weight, (s16)tap1.weight, (s16)tap1.weight,
+                                               (s16)tap0.weight, (s16)tap0.weight, (s16)tap0.weight, (s16)tap0.weight);
+
+        __m128i const top = LerpChannels(top_left, top_right, weight_x);
+        __m128i const bottom = LerpChannels(bottom_left, bottom_right, weight_x);
+        __m128i const result = LerpChannels(top, bottom, weight_y_lanes);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(target_row + x), _mm_packus_epi16(result, zero));
+    }
+#endif
+
+    for (; x < width; ++x) {
+        UpscaleTap const& tap = taps[x];
+        u32 const top = LerpPixel(row0[tap.x0], row0[tap.x1], tap.weight);
+        u32 const bottom = LerpPixel(row1[tap.x0], row1[tap.x1], tap.weight);
+        target_row[x] = LerpPixel(top, bottom, weight_y);
+    }
+}
+
+// Fills the framebuffer with the render resolution image scaled up to the window.
+static void UpscaleColorBuffer(Renderer* renderer) {
+    u32* target = renderer->upscaled_color_buffer;
+    size_t target_stride = renderer->max_buffer_width;
+    bool is_target_locked = false;
+    if (renderer->present_mode == PresentMode::LockedTexture) {
+        void* pixels = nullptr;
+        s32 pitch = 0;
+        if (SDL_LockTexture(renderer->framebuffer, nullptr, &pixels, &pitch) == 0) {
+            target = static_cast<u32*>(pixels);
+            target_stride = (size_t)pitch / sizeof(u32);
+            is_target_locked = true;
+        } else {
+            gfx_error("Could not lock the framebuffer, falling back to copy present: {0}", SDL_GetError());
+            renderer->present_mode = PresentMode::Copy;
+        }
+    }
+
+    auto upscale_rows = [renderer, target, target_stride](size_t first_row, size_t last_row, u32) {
+        for (size_t y = first_row; y < last_row; ++y) {
+            UpscaleRow(renderer, y, target + y * target_stride);
+        }
+    };
+    ParallelFor(&renderer->job_system, renderer->max_buffer_height, L1_TILE_SIZE, upscale_rows);
+
+    if (is_target_locked) {
+        SDL_UnlockTexture(renderer->framebuffer);
+    } else {
+        SDL_UpdateTexture(renderer->framebuffer, nullptr, target, (s32)(sizeof(u32) * target_stride));
+    }
+}
+
+// Hands the finished color buffer to SDL and records the copy and UI, SDL_RenderPresent is left to the caller.
+static void ResolveFramebuffer(Renderer* renderer) {
+    if (IsUpscaling(renderer)) {
+        UpscaleColorBuffer(renderer);
+    } else if (renderer->is_framebuffer_locked) {
+        // The frame already lives in the texture.
+        SDL_UnlockTexture(renderer->framebuffer);
+        renderer->is_framebuffer_locked = false;
+    } else {
+        SDL_UpdateTexture(renderer->framebuffer, nullptr, renderer->color_buffer, renderer->color_buffer_pitch);
+    }
+
     SDL_RenderCopy(renderer->sdl_renderer, renderer->framebuffer, nullptr, nullptr);
     ImGui_ImplSDLRenderer_RenderDrawData(ImGui::GetDrawData());
-    SDL_RenderPresent(renderer->sdl_renderer);
+    renderer->presented_framebuffer = renderer->framebuffer;
+    renderer->has_previous_frame = true;
+
+    // Next frame goes into the other texture while this one is displayed.
+    renderer->framebuffer_index = (renderer->framebuffer_index + 1) % renderer->framebuffer_count;
+    renderer->framebuffer = renderer->framebuffers[renderer->framebuffer_index];
+}
+
+static void ClearL0Tile(Renderer* renderer, size_t tile_index) {
+    Tile const& tile = renderer->l0_tiles[tile_index];
+    if (tile.orig_x0 >= renderer->buffer_width || tile.orig_y0 >= renderer->buffer_height)
+        return;
+
+    size_t const x_end = std::min<size_t>(tile.orig_x3, renderer->buffer_width);
+    size_t const y_end = std::min<size_t>(tile.orig_y3, renderer->buffer_height);
+    size_t const row_width = x_end - tile.orig_x0;
+    for (size_t y = tile.orig_y0; y < y_end; ++y) {
+        std::memset(renderer->color_buffer + y * renderer->color_buffer_stride + tile.orig_x0, 0x00,
+                    row_width * sizeof(u32));
+    }
+    ClearDepthTiles(&renderer->depth_buffer, tile.orig_x0, tile.orig_y0, x_end, y_end);
+}
+
+static void RasterizeL0Tile(Renderer* renderer, FrameSlot const* slot, size_t tile_index);
+
+void Present(Renderer* renderer) {
+    if (renderer->frame_update == FrameUpdate::Reuse) {
+        // The last texture still holds the image, only the UI is new.
+        SDL_RenderCopy(renderer->sdl_renderer, renderer->presented_framebuffer, nullptr, nullptr);
+        ImGui_ImplSDLRenderer_RenderDrawData(ImGui::GetDrawData());
+        SDL_RenderPresent(renderer->sdl_renderer);
+        renderer->frame_update = FrameUpdate::Full;
+        return;
+    }
+
+    renderer->frame_update = FrameUpdate::Full;
+
+    if (!renderer->is_pipelined) {
+        ResolveFramebuffer(renderer);
+        SDL_RenderPresent(renderer->sdl_renderer);
+        return;
+    }
+
+    // The previous frame rasterized while this one was being binned. The UI recorded this frame goes on top of it.
+    bool const has_previous_frame = renderer->raster_job != nullptr;
+    if (has_previous_frame) {
+        WaitForRenderer(renderer);
+        ResolveFramebuffer(renderer);
+    }
+
+    // Start rasterizing this frame before blocking in SDL_RenderPresent, workers keep going through the vsync wait and
+    // the next frame's update and binning.
+    AcquireColorBuffer(renderer);
+    FrameSlot const* slot = GetCurrentFrameSlot(renderer);
+    auto clear_and_rasterize_tiles = [renderer, slot](size_t first_tile, size_t last_tile, u32) {
+        for (size_t tile_index = first_tile; tile_index < last_tile; ++tile_index) {
+            ClearL0Tile(renderer, tile_index);
+            RasterizeL0Tile(renderer, slot, tile_index);
+        }
+    };
+    JobGroup raster_jobs =
+        CreateParallelFor(&renderer->job_system, renderer->l0_tile_count, 1, clear_and_rasterize_tiles);
+    SubmitJob(&renderer->job_system, raster_jobs.begin);
+    renderer->raster_job = raster_jobs.end;
+    renderer->frame_slot_index = (renderer->frame_slot_index + 1) % FRAME_SLOT_COUNT;
+
+    if (has_previous_frame) {
+        SDL_RenderPresent(renderer->sdl_renderer);
+    }
+}
+
+void WaitForRenderer(Renderer* renderer) {
+    if (renderer->raster_job == nullptr)
+        return;
+
+    WaitForJob(&renderer->job_system, renderer->raster_job);
+    renderer->raster_job = nullptr;
 }
 
 void PutPixel(Renderer* renderer, u32 x, u32 y, u32 color) {
-    renderer->color_buffer[y * renderer->buffer_width + x] = color;
+    renderer->color_buffer[y * renderer->color_buffer_stride + x] = color;
 }
 
 void PutPixel(Renderer* renderer, u32 x, u32 y, vec3f const& color) {
     vec3f color_scaled = color * 255.0f;
     u32 color_8bpc = RGB((u8)color_scaled.x, (u8)color_scaled.y, (u8)color_scaled.z);
-    renderer->color_buffer[y * renderer->buffer_width + x] = color_8bpc;
+    renderer->color_buffer[y * renderer->color_buffer_stride + x] = color_8bpc;
 }
 
 void DrawRect(Renderer* renderer, s32 x0, s32 y0, s32 w, s32 h, u32 color) {
-    // Most naive approach.
-    for (s32 y = y0; y < (y0 + h); ++y) {
-        for (s32 x = x0; x < (x0 + w); ++x) {
-            PutPixel(renderer, x, y, color);
-        }
+    // One span per row, DrawHorizontalLine clips.
+    s32 const y_begin = std::max(y0, 0);
+    s32 const y_end = std::min(y0 + h, (s32)renderer->buffer_height);
+    for (s32 y = y_begin; y < y_end; ++y) {
+        DrawHorizontalLine(renderer, x0, x0 + w, y, color);
     }
 }
 
 void DrawRect(Renderer* renderer, vec2i const& position, vec2i const& size, u32 color) {
-    // Most naive approach.
-    for (s32 y = position.y; y < (position.y + size.y); ++y) {
-        for (s32 x = position.x; x < (position.x + size.x); ++x) {
-            PutPixel(renderer, x, y, color);
+    DrawRect(renderer, position.x, position.y, size.x, size.y, color);
+}
+
+bool SetupTrianglePositions(Renderer* renderer, vec4f const& v0_clip, vec4f const& v1_clip, vec4f const& v2_clip,
+                            InterpolatedTriangle* triangle) {
+    if (v0_clip.w < 1.0f || v1_clip.w < 1.0f || v2_clip.w < 1.0f)
+        return false;
+
+    vec3f v0_ndc = vec3f(v0_clip / v0_clip.w);
+    vec3f v1_ndc = vec3f(v1_clip / v1_clip.w);
+    vec3f v2_ndc = vec3f(v2_clip / v2_clip.w);
+
+    vec2f v0_screen_space_pretransform = (vec2f(v0_ndc) + vec2f(1.0f)) / 2.0f;
+    vec2f v1_screen_space_pretransform = (vec2f(v1_ndc) + vec2f(1.0f)) / 2.0f;
+    vec2f v2_screen_space_pretransform = (vec2f(v2_ndc) + vec2f(1.0f)) / 2.0f;
+
+    // Screen-space (or viewport space) is top-left origin, the upper code has bottom-left origin
+    v0_screen_space_pretransform.y = 1.0f - v0_screen_space_pretransform.y;
+    v1_screen_space_pretransform.y = 1.0f - v1_screen_space_pretransform.y;
+    v2_screen_space_pretransform.y = 1.0f - v2_screen_space_pretransform.y;
+
+    vec2f const viewport_size = vec2f(renderer->fBuffer_width, renderer->fBuffer_heigth);
+    triangle->screen_space.p0 = v0_screen_space_pretransform * viewport_size;
+    triangle->screen_space.p1 = v1_screen_space_pretransform * viewport_size;
+    triangle->screen_space.p2 = v2_screen_space_pretransform * viewport_size;
+
+    // Store 1/ndc.w for all vertices (after clipping)
+    // Divide all of our vertex attributes and depth by ndc.w, call it U~
+    // Interpolate 1/ndc.w according to barycentric coordinates
+    // Interpolate all divided(i.e. U~) vertex attributes according to barycentric coordinates
+    // Divide the interpolated divided vertex attributes by 1/ndc.w
+    // Profit ??
+
+    // Step 1
+    triangle->v0_pw_rcp = 1.0f / v0_clip.w;
+    triangle->v1_pw_rcp = 1.0f / v1_clip.w;
+    triangle->v2_pw_rcp = 1.0f / v2_clip.w;
+    return true;
+}
+
+bool SetupInterpolatedTriangle(Renderer* renderer, vec4f const& v0_clip, vec4f const& v1_clip, vec4f const& v2_clip,
+                               InterpolatedTriangle* triangle) {
+    if (!SetupTrianglePositions(renderer, v0_clip, v1_clip, v2_clip, triangle))
+        return false;
+
+    // Step 2
+    triangle->attributes_w.v0_color = vec3f(1.0f, 0.0f, 0.0f) * triangle->v0_pw_rcp;
+    triangle->attributes_w.v1_color = vec3f(0.0f, 1.0f, 0.0f) * triangle->v1_pw_rcp;
+    triangle->attributes_w.v2_color = vec3f(0.0f, 0.0f, 1.0f) * triangle->v2_pw_rcp;
+    return true;
+}
+
+// Depth-only triangles skip attribute setup.
+static bool SetupTriangle(Renderer* renderer, vec4f const& v0_clip, vec4f const& v1_clip, vec4f const& v2_clip,
+                          DrawMode mode, InterpolatedTriangle* triangle) {
+    if (mode == DrawMode::DepthOnly) {
+        return SetupTrianglePositions(renderer, v0_clip, v1_clip, v2_clip, triangle);
+    }
+    return SetupInterpolatedTriangle(renderer, v0_clip, v1_clip, v2_clip, triangle);
+}
+
+void DrawMesh(Renderer* renderer, Mesh* mesh, glm::mat4 const& mvp, u32 lod, DrawMode mode) {
+    // Binned draws only rasterize the tiles this frame redraws.
+    if (renderer->is_pipelined || renderer->frame_update != FrameUpdate::Full || mode == DrawMode::Wireframe) {
+        glm::mat4 const transform = glm::mat4(1.0f);
+        DrawMeshInstanced(renderer, mesh, mvp, &transform, 1, lod, mode);
+        return;
+    }
+
+    ForEachMeshLodTriangle(mesh, lod, [&](u32 index0, u32 index1, u32 index2) {
+        vec4f v0_clip = mvp * vec4f(GetMeshVertexPosition(mesh, index0), 1.0f);
+        vec4f v1_clip = mvp * vec4f(GetMeshVertexPosition(mesh, index1), 1.0f);
+        vec4f v2_clip = mvp * vec4f(GetMeshVertexPosition(mesh, index2), 1.0f);
+
+        InterpolatedTriangle triangle{};
+        if (SetupTriangle(renderer, v0_clip, v1_clip, v2_clip, mode, &triangle)) {
+            DrawTriangle3D(renderer, &triangle, mode);
+        }
+    });
+}
+
+// Clip-space position of every vertex of the mesh. Quantized positions are decoded by the transform itself, the
+// dequantization is folded into the matrix.
+static void TransformMeshVertices(Mesh const* mesh, glm::mat4 const& mvp, vec4f* clip_vertices) {
+    if (!mesh->is_quantized) {
+        for (size_t vertex_index = 0; vertex_index < mesh->vertices.size(); ++vertex_index) {
+            clip_vertices[vertex_index] = mvp * vec4f(mesh->vertices[vertex_index], 1.0f);
         }
+        return;
+    }
+
+    QuantizedMesh const& quantized = mesh->quantized;
+    glm::mat4 const dequantize_mvp = mvp * glm::translate(glm::mat4(1.0f), quantized.position_offset) *
+                                     glm::scale(glm::mat4(1.0f), quantized.position_scale);
+    size_t const vertex_count = quantized.vertices.size();
+    size_t vertex_index = 0;
+
+#ifdef GFX_SSE2
+    __m128 const column0 = _mm_loadu_ps(&dequantize_mvp[0][0]);
+    __m128 const column1 = _mm_loadu_ps(&dequantize_mvp[1][0]);
+    __m128 const column2 = _mm_loadu_ps(&dequantize_mvp[2][0]);
+    __m128 const column3 = _mm_loadu_ps(&dequantize_mvp[3][0]);
+    __m128i const zero = _mm_setzero_si128();
+    for (; vertex_index < vertex_count; ++vertex_index) {
+        // One 8-byte load, the normal lands in the unused fourth lane.
+        __m128i const packed = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(&quantized.vertices[vertex_index]));
+        __m128 const position = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+        __m128 const x = _mm_shuffle_ps(position, position, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 const y = _mm_shuffle_ps(position, position, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 const z = _mm_shuffle_ps(position, position, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 clip = _mm_add_ps(column3, _mm_mul_ps(column0, x));
+        clip = _mm_add_ps(clip, _mm_mul_ps(column1, y));
+        clip = _mm_add_ps(clip, _mm_mul_ps(column2, z));
+        _mm_storeu_ps(&clip_vertices[vertex_index].x, clip);
+    }
+#endif
+
+    for (; vertex_index < vertex_count; ++vertex_index) {
+        u16 const* position = quantized.vertices[vertex_index].position;
+        clip_vertices[vertex_index] =
+            dequantize_mvp * vec4f((f32)position[0], (f32)position[1], (f32)position[2], 1.0f);
     }
 }
 
-void DrawMesh(Renderer* renderer, Mesh* mesh, glm::mat4 const& mvp) {
+static void PushToTileBin(FrameArena* arena, TileBin* bin, InterpolatedTriangle const* triangle, u64 sequence) {
+    TileBinChunk* current = bin->current;
+    if (current == nullptr || current->sequence != sequence || current->count == TILE_BIN_CHUNK_SIZE) {
+        TileBinChunk* chunk = ArenaAllocateArray<TileBinChunk>(arena, 1);
+        chunk->sequence = sequence;
+        chunk->count = 0;
+
+        // A full chunk continues right after itself. A new batch usually comes after everything binned so far, unless
+        // the worker stole it from further back.
+        TileBinChunk* previous = nullptr;
+        if (current != nullptr && current->sequence == sequence) {
+            previous = current;
+        } else if (bin->last != nullptr && bin->last->sequence < sequence) {
+            previous = bin->last;
+        } else {
+            for (TileBinChunk* other = bin->first; other != nullptr && other->sequence < sequence;
+                 other = other->next) {
+                previous = other;
+            }
+        }
 
-    for (size_t triangle_index = 0; triangle_index < mesh->triangles.size(); ++triangle_index) {
-        u32 index0 = mesh->triangles[triangle_index].indices[0];
-        u32 index1 = mesh->triangles[triangle_index].indices[1];
-        u32 index2 = mesh->triangles[triangle_index].indices[2];
+        if (previous == nullptr) {
+            chunk->next = bin->first;
+            bin->first = chunk;
+        } else {
+            chunk->next = previous->next;
+            previous->next = chunk;
+        }
+        if (chunk->next == nullptr) {
+            bin->last = chunk;
+        }
+        bin->current = chunk;
+    }
+    bin->current->triangles[bin->current->count++] = triangle;
+}
 
-        vec4f v0_clip = mvp * vec4f(mesh->vertices[index0], 1.0f);
-        vec4f v1_clip = mvp * vec4f(mesh->vertices[index1], 1.0f);
-        vec4f v2_clip = mvp * vec4f(mesh->vertices[index2], 1.0f);
+// Pixel centers inside the triangle's bounds. False when there are none, the triangle can't cover a pixel. Marks the
+// triangle small when they fit in a SMALL_TRIANGLE_SAMPLE_SPAN square. Expects bounds that overlap the buffer.
+static bool ClassifyTriangle(InterpolatedTriangle* triangle, vec2f const& origin, vec2f const& origin_plus_size) {
+    // Pixel x has its center at x + 0.5.
+    f32 const sample_x0 = std::ceil(origin.x - 0.5f);
+    f32 const sample_y0 = std::ceil(origin.y - 0.5f);
+    f32 const sample_x1 = std::floor(origin_plus_size.x - 0.5f);
+    f32 const sample_y1 = std::floor(origin_plus_size.y - 0.5f);
+    if (sample_x1 < sample_x0 || sample_y1 < sample_y0)
+        return false;
 
-        if (v0_clip.w < 1.0f || v1_clip.w < 1.0f || v2_clip.w < 1.0f)
-            continue;
+    triangle->is_small = sample_x1 - sample_x0 < (f32)SMALL_TRIANGLE_SAMPLE_SPAN &&
+                         sample_y1 - sample_y0 < (f32)SMALL_TRIANGLE_SAMPLE_SPAN;
+    if (triangle->is_small) {
+        triangle->sample_x = (s32)sample_x0;
+        triangle->sample_y = (s32)sample_y0;
+    }
+    return true;
+}
+
+// Adds the triangle to every L0 tile its screen-space bounds touch.
+static void BinInterpolatedTriangle(Renderer* renderer, FrameArena* arena, BinningContext* context, DrawMode mode,
+                                    u64 sequence, InterpolatedTriangle& triangle) {
+    vec2f origin, size;
+    GetTriangleAABB(triangle.screen_space.p0, triangle.screen_space.p1, triangle.screen_space.p2, origin, size);
+    vec2f origin_plus_size = origin + size;
 
-        vec3f v0_ndc = vec3f(v0_clip / v0_clip.w);
-        vec3f v1_ndc = vec3f(v1_clip / v1_clip.w);
-        vec3f v2_ndc = vec3f(v2_clip / v2_clip.w);
+    if (origin_plus_size.x < 0.0f || origin_plus_size.y < 0.0f || origin.x >= renderer->fBuffer_width ||
+        origin.y >= renderer->fBuffer_heigth)
+        return;
 
-        vec2f v0_screen_space_pretransform = vec2f(v0_ndc) + vec2f(1.0f) / 2.0f;
-        vec2f v1_screen_space_pretransform = vec2f(v1_ndc) + vec2f(1.0f) / 2.0f;
-        vec2f v2_screen_space_pretransform = vec2f(v2_ndc) + vec2f(1.0f) / 2.0f;
+    if (!ClassifyTriangle(&triangle, origin, origin_plus_size))
+        return;
 
-        // Screen-space (or viewport space) is top-left origin, the upper code has bottom-left origin
-        v0_screen_space_pretransform.y = 1.0f - v0_screen_space_pretransform.y;
-        v1_screen_space_pretransform.y = 1.0f - v1_screen_space_pretransform.y;
-        v2_screen_space_pretransform.y = 1.0f - v2_screen_space_pretransform.y;
+    s32 const last_tile_x = (s32)((renderer->buffer_width - 1) / L0_TILE_SIZE);
+    s32 const last_tile_y = (s32)((renderer->buffer_height - 1) / L0_TILE_SIZE);
+    s32 tile_x0 = std::clamp((s32)origin.x / (s32)L0_TILE_SIZE, 0, last_tile_x);
+    s32 tile_y0 = std::clamp((s32)origin.y / (s32)L0_TILE_SIZE, 0, last_tile_y);
+    s32 tile_x1 = std::clamp((s32)origin_plus_size.x / (s32)L0_TILE_SIZE, 0, last_tile_x);
+    s32 tile_y1 = std::clamp((s32)origin_plus_size.y / (s32)L0_TILE_SIZE, 0, last_tile_y);
 
-        InterpolatedTriangle triangle{};
-        triangle.screen_space.p0 = (v0_screen_space_pretransform)*vec2f(800.0f, 600.0f);
-        triangle.screen_space.p1 = (v1_screen_space_pretransform)*vec2f(800.0f, 600.0f);
-        triangle.screen_space.p2 = (v2_screen_space_pretransform)*vec2f(800.0f, 600.0f);
+    TileBin*& tile_bins = context->tile_bins[(u32)mode];
+    if (tile_bins == nullptr) {
+        tile_bins = ArenaAllocateArray<TileBin>(arena, renderer->l0_tile_count);
+        std::memset(tile_bins, 0, sizeof(TileBin) * renderer->l0_tile_count);
+    }
+
+    InterpolatedTriangle* stored = ArenaAllocateArray<InterpolatedTriangle>(arena, 1);
+    new (stored) InterpolatedTriangle(triangle);
+
+    size_t const pitch = renderer->l0_tile_count_pitch;
+    for (s32 tile_y = tile_y0; tile_y <= tile_y1; ++tile_y) {
+        for (s32 tile_x = tile_x0; tile_x <= tile_x1; ++tile_x) {
+            size_t const tile_index = tile_y * pitch + tile_x;
+            if (IsL0TileRedrawn(renderer, tile_index)) {
+                PushToTileBin(arena, &tile_bins[tile_index], stored, sequence);
+            }
+        }
+    }
+}
+
+static void DrawTriangles(Renderer* renderer, InterpolatedTriangle const* const* triangles, u32 count,
+                          vec2i const& clip_min, vec2i const& clip_max, DrawMode mode);
+
+static void RasterizeL0Tile(Renderer* renderer, FrameSlot const* slot, size_t tile_index) {
+    Tile const& tile = renderer->l0_tiles[tile_index];
+    if (tile.orig_x0 >= renderer->buffer_width || tile.orig_y0 >= renderer->buffer_height)
+        return;
+
+    vec2i clip_min = {(s32)tile.orig_x0, (s32)tile.orig_y0};
+    vec2i clip_max = {(s32)std::min<size_t>(tile.orig_x3, renderer->buffer_width),
+                      (s32)std::min<size_t>(tile.orig_y3, renderer->buffer_height)};
+
+    // Every batch was binned by one worker and each bin is sorted, so merging the chunks of all modes and contexts by
+    // sequence replays the triangles in submission order. Ties at equal depth resolve the same way every run, and a
+    // prepass only runs ahead of its color pass because it was submitted first.
+    struct BinCursor {
+        TileBinChunk const* chunk;
+        DrawMode mode;
+    };
+    BinCursor cursors[BINNED_DRAW_MODE_COUNT * MAX_JOB_WORKERS];
+    u32 cursor_count = 0;
+    for (u32 mode = 0; mode < BINNED_DRAW_MODE_COUNT; ++mode) {
+        for (BinningContext const& context : slot->binning_contexts) {
+            TileBin const* tile_bins = context.tile_bins[mode];
+            if (tile_bins != nullptr && tile_bins[tile_index].first != nullptr) {
+                cursors[cursor_count++] = {tile_bins[tile_index].first, (DrawMode)mode};
+            }
+        }
+    }
+
+    while (cursor_count > 0) {
+        u32 next = 0;
+        for (u32 cursor = 1; cursor < cursor_count; ++cursor) {
+            if (cursors[cursor].chunk->sequence < cursors[next].chunk->sequence) {
+                next = cursor;
+            }
+        }
+
+        TileBinChunk const* chunk = cursors[next].chunk;
+        DrawTriangles(renderer, chunk->triangles, chunk->count, clip_min, clip_max, cursors[next].mode);
+        cursors[next].chunk = chunk->next;
+        if (cursors[next].chunk == nullptr) {
+            cursors[next] = cursors[--cursor_count];
+        }
+    }
+}
+
+static constexpr u32 WIREFRAME_COLOR = RGB(255, 255, 255);
+
+// Every triangle draws its three edges, so an edge shared by two triangles is drawn twice. On DirtyTiles frames the
+// lines outside the dirty tiles land on the same pixels the previous frame's did.
+static void DrawMeshWireframe(Renderer* renderer, Mesh* mesh, glm::mat4 const& view_projection,
+                              glm::mat4 const* transforms, size_t instance_count, u32 lod, FrameArena* arena) {
+    vec4f* clip_vertices = ArenaAllocateArray<vec4f>(arena, GetMeshVertexCount(mesh));
+    for (size_t instance_index = 0; instance_index < instance_count; ++instance_index) {
+        TransformMeshVertices(mesh, view_projection * transforms[instance_index], clip_vertices);
+
+        ForEachMeshLodTriangle(mesh, lod, [&](u32 index0, u32 index1, u32 index2) {
+            DrawLine3D(renderer, clip_vertices[index0], clip_vertices[index1], WIREFRAME_COLOR);
+            DrawLine3D(renderer, clip_vertices[index1], clip_vertices[index2], WIREFRAME_COLOR);
+            DrawLine3D(renderer, clip_vertices[index2], clip_vertices[index0], WIREFRAME_COLOR);
+        });
+    }
+}
+
+void DrawMeshInstanced(Renderer* renderer, Mesh* mesh, glm::mat4 const& view_projection, glm::mat4 const* transforms,
+                       size_t instance_count, u32 lod, DrawMode mode) {
+    if (instance_count == 0 || renderer->frame_update == FrameUpdate::Reuse)
+        return;
 
-        // Store 1/ndc.w for all vertices (after clipping)
-        // Divide all of our vertex attributes and depth by ndc.w, call it U~
-        // Interpolate 1/ndc.w according to barycentric coordinates
-        // Interpolate all divided(i.e. U~) vertex attributes according to barycentric coordinates
-        // Divide the interpolated divided vertex attributes by 1/ndc.w
-        // Profit ??
+    size_t const vertex_count = GetMeshVertexCount(mesh);
 
-        // Step 1
-        triangle.v0_pw_rcp = 1.0f / v0_clip.w;
-        triangle.v1_pw_rcp = 1.0f / v1_clip.w;
-        triangle.v2_pw_rcp = 1.0f / v2_clip.w;
+    JobSystem* job_system = &renderer->job_system;
+    FrameSlot* slot = GetCurrentFrameSlot(renderer);
 
-        // ImGui::PushID(triangle_index);
-        // ImGui::Text("Triangle Index: %zu", triangle_index);
-        // ImGui::Text("Vertex 0: [z: %.4f] [1/w: %.4f]", v0_ndc.z, triangle.v0_pw_rcp);
-        // ImGui::Text("Vertex 1: [z: %.4f] [1/w: %.4f]", v1_ndc.z, triangle.v1_pw_rcp);
-        // ImGui::Text("Vertex 2: [z: %.4f] [1/w: %.4f]", v2_ndc.z, triangle.v2_pw_rcp);
-        // ImGui::Separator();
-        // ImGui::PopID();
+    // Lines go straight into the color buffer, nothing else may be rasterizing into it.
+    if (mode == DrawMode::Wireframe) {
+        if (!renderer->is_pipelined) {
+            DrawMeshWireframe(renderer, mesh, view_projection, transforms, instance_count, lod, &slot->frame_arenas[0]);
+        }
+        return;
+    }
 
-        // Step 2
-        triangle.attributes_w.v0_color = vec3f(1.0f, 0.0f, 0.0f) / v0_clip.w;
-        triangle.attributes_w.v1_color = vec3f(0.0f, 1.0f, 0.0f) / v1_clip.w;
-        triangle.attributes_w.v2_color = vec3f(0.0f, 0.0f, 1.0f) / v2_clip.w;
+    // Pipelined draws pile up in the frame slot until Present, otherwise every draw is rasterized right away.
+    if (!renderer->is_pipelined) {
+        ResetBinningContexts(slot);
+    }
 
-        DrawTriangle3D(renderer, &triangle);
+    // Transform, setup and binning. Every instance's triangles end up in the same set of tile bins, one set per worker
+    // so binning needs no synchronization.
+    u32 const draw_index = slot->draw_count++;
+    auto transform_and_bin = [&](size_t first_instance, size_t last_instance, u32 worker_index) {
+        BinningContext& context = slot->binning_contexts[worker_index];
+        u64 const sequence = GetBinSequence(draw_index, first_instance);
+        FrameArena* arena = &slot->frame_arenas[worker_index];
+        vec4f* clip_vertices = ArenaAllocateArray<vec4f>(arena, vertex_count);
+
+        for (size_t instance_index = first_instance; instance_index < last_instance; ++instance_index) {
+            TransformMeshVertices(mesh, view_projection * transforms[instance_index], clip_vertices);
+
+            ForEachMeshLodTriangle(mesh, lod, [&](u32 index0, u32 index1, u32 index2) {
+                InterpolatedTriangle triangle{};
+                if (SetupTriangle(renderer, clip_vertices[index0], clip_vertices[index1], clip_vertices[index2], mode,
+                                  &triangle)) {
+                    BinInterpolatedTriangle(renderer, arena, &context, mode, sequence, triangle);
+                }
+            });
+        }
+    };
+
+    JobGroup bin_jobs = CreateParallelFor(job_system, instance_count, INSTANCE_BATCH_SIZE, transform_and_bin);
+    if (renderer->is_pipelined) {
+        // Transforms are only valid for the duration of the call, the bins are self-contained.
+        SubmitJob(job_system, bin_jobs.begin);
+        WaitForJob(job_system, bin_jobs.end);
+        return;
     }
+
+    // Tiles don't overlap, so workers can rasterize them without any synchronization.
+    auto rasterize_tiles = [renderer, slot](size_t first_tile, size_t last_tile, u32) {
+        for (size_t tile_index = first_tile; tile_index < last_tile; ++tile_index) {
+            if (IsL0TileRedrawn(renderer, tile_index)) {
+                RasterizeL0Tile(renderer, slot, tile_index);
+            }
+        }
+    };
+
+    JobGroup raster_jobs = CreateParallelFor(job_system, renderer->l0_tile_count, 1, rasterize_tiles);
+    AddJobDependency(job_system, bin_jobs.end, raster_jobs.begin);
+
+    SubmitJob(job_system, bin_jobs.begin);
+    WaitForJob(job_system, raster_jobs.end);
 }
 
 void DrawTriangle2D(Renderer* renderer, Triangle2D* tri) {
@@ -364,9 +1013,17 @@ void DrawTriangle2D(Renderer* renderer, Triangle2D* tri) {
     GetTriangleAABB(tri->vtx_pos0, tri->vtx_pos1, tri->vtx_pos2, origin, size);
     // origin + size
     vec2f origin_plus_size = origin + size;
-    // Go over the triangle rect.
-    for (u32 y = (u32)(origin.y - 0.5f); y <= (u32)origin_plus_size.y; ++y) {
-        for (u32 x = (u32)(origin.x - 0.5f); x <= (u32)origin_plus_size.x; ++x) {
+    // Go over the triangle rect, clipped to the buffer.
+    s32 const x_min = std::max((s32)(origin.x - 0.5f), 0);
+    s32 const y_min = std::max((s32)(origin.y - 0.5f), 0);
+    s32 const x_max = std::min((s32)origin_plus_size.x, (s32)renderer->buffer_width - 1);
+    s32 const y_max = std::min((s32)origin_plus_size.y, (s32)renderer->buffer_height - 1);
+    size_t const pitch = renderer->l0_tile_count_pitch;
+    for (s32 y = y_min; y <= y_max; ++y) {
+        for (s32 x = x_min; x <= x_max; ++x) {
+            // It's drawn under the scene, so tiles this frame doesn't redraw must keep the scene drawn over it.
+            if (!IsL0TileRedrawn(renderer, (y / L0_TILE_SIZE) * pitch + x / L0_TILE_SIZE))
+                continue;
             vec2f sample{(f32)x + 0.5f, (f32)y + 0.5f};
             // Check if the point in the AABB rect lies in the triangle, if so put the pixel in it.
             if (IsPointInsideTriangle(sample, tri->vtx_pos0, tri->vtx_pos1, tri->vtx_pos2)) {
@@ -376,68 +1033,446 @@ void DrawTriangle2D(Renderer* renderer, Triangle2D* tri) {
     }
 }
 
-void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle* tri) {
+void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle const* tri, DrawMode mode) {
+    DrawTriangle3D(renderer, tri, vec2i(0, 0), vec2i((s32)renderer->buffer_width, (s32)renderer->buffer_height), mode);
+}
+
+// 1/w as a plane over raster space. lambda0 = E12 / area and so on, their gradients come straight from the edges.
+static DepthPlane GetTriangleDepthPlane(InterpolatedTriangle const* tri, f32 parallelogram_area) {
+    vec2f const& p0 = tri->screen_space.p0;
+    vec2f const& p1 = tri->screen_space.p1;
+    vec2f const& p2 = tri->screen_space.p2;
+
+    DepthPlane plane;
+    plane.a = -((p2.y - p1.y) * tri->v0_pw_rcp + (p0.y - p2.y) * tri->v1_pw_rcp + (p1.y - p0.y) * tri->v2_pw_rcp) /
+              parallelogram_area;
+    plane.b = ((p2.x - p1.x) * tri->v0_pw_rcp + (p0.x - p2.x) * tri->v1_pw_rcp + (p1.x - p0.x) * tri->v2_pw_rcp) /
+              parallelogram_area;
+    plane.c = tri->v0_pw_rcp - plane.a * p0.x - plane.b * p0.y;
+    return plane;
+}
+
+__forceinline static void ShadeTrianglePixel(Renderer* renderer, InterpolatedTriangle const* tri,
+                                             f32 parallelogram_area, s32 x, s32 y, f32 E01, f32 E12, f32 E20) {
+    // Barycentric coordinates
+    f32 lambda0 = E12 / parallelogram_area;
+    f32 lambda1 = E20 / parallelogram_area;
+    f32 lambda2 = E01 / parallelogram_area;
+
+    // 1/P~w interpolated
+    f32 rcp_pw_interp = lambda0 * tri->v0_pw_rcp + lambda1 * tri->v1_pw_rcp + lambda2 * tri->v2_pw_rcp;
+    vec3f color_interp = lambda0 * tri->attributes_w.v0_color + lambda1 * tri->attributes_w.v1_color +
+                         lambda2 * tri->attributes_w.v2_color;
+    color_interp = color_interp / rcp_pw_interp;
+    PutPixel(renderer, x, y, color_interp);
+}
+
+// +1 when the plane is in front of everything in the tile, -1 when it's behind everything, 0 when it depends on the
+// pixel. Depth differences are linear, so checking the corner pixels covers the whole tile. Pixels compare encoded
+// depths, so behind takes a gap of more than one encoding step, doubled to absorb rounding.
+static s32 CompareToDepthTile(DepthTile const& tile, DepthFormat format, DepthPlane const& plane, size_t x0, size_t y0,
+                              size_t x1, size_t y1) {
+    if (tile.state == DepthTileState::Clear)
+        return 1;
+
+    f32 const behind_margin = 2.0f * GetDepthEncodingStep(format);
+
+    size_t const corners_x[4] = {x0, x1 - 1, x0, x1 - 1};
+    size_t const corners_y[4] = {y0, y0, y1 - 1, y1 - 1};
+    u32 const plane_count = tile.state == DepthTileState::TwoPlanes ? 2 : 1;
+
+    bool is_in_front = true;
+    bool is_behind = true;
+    for (u32 corner = 0; corner < 4; ++corner) {
+        f32 depth = EvaluateDepthPlane(plane, corners_x[corner], corners_y[corner]);
+        for (u32 plane_index = 0; plane_index < plane_count; ++plane_index) {
+            f32 tile_depth = EvaluateDepthPlane(tile.planes[plane_index], corners_x[corner], corners_y[corner]);
+            is_in_front &= depth >= tile_depth;
+            is_behind &= depth + behind_margin < tile_depth;
+        }
+    }
+    return is_in_front ? 1 : (is_behind ? -1 : 0);
+}
+
+__forceinline static bool IsSameDepthPlane(DepthPlane const& lhs, DepthPlane const& rhs) {
+    return lhs.a == rhs.a && lhs.b == rhs.b && lhs.c == rhs.c;
+}
+
+// Rasterizes the part [x0, x1) x [y0, y1) of the triangle that falls into a single depth tile. Instantiated per draw
+// mode so the depth-only kernel carries no barycentrics or shading at all.
+template <DrawMode mode>
+static void DrawTriangleDepthTile(Renderer* renderer, InterpolatedTriangle const* tri, DepthPlane const& plane,
+                                  f32 parallelogram_area, s32 x0, s32 y0, s32 x1, s32 y1) {
+    constexpr bool writes_color = mode != DrawMode::DepthOnly;
+    constexpr bool writes_depth = mode != DrawMode::ColorEqualDepth;
+
+    DepthBuffer* depth_buffer = &renderer->depth_buffer;
+    size_t const tile_index = GetDepthTileIndex(depth_buffer, x0, y0);
+    DepthTile& tile = depth_buffer->tiles[tile_index];
+
+    size_t tile_x0, tile_y0, tile_x1, tile_y1;
+    GetDepthTileRect(depth_buffer, tile_index, tile_x0, tile_y0, tile_x1, tile_y1);
+    bool const covers_tile = (size_t)x0 == tile_x0 && (size_t)y0 == tile_y0 && (size_t)x1 == tile_x1 &&
+                             (size_t)y1 == tile_y1 &&
+                             IsPointInsideTriangle({(f32)x0 + 0.5f, (f32)y0 + 0.5f}, tri->screen_space.p0,
+                                                   tri->screen_space.p1, tri->screen_space.p2) &&
+                             IsPointInsideTriangle({(f32)x1 - 0.5f, (f32)y0 + 0.5f}, tri->screen_space.p0,
+                                                   tri->screen_space.p1, tri->screen_space.p2) &&
+                             IsPointInsideTriangle({(f32)x0 + 0.5f, (f32)y1 - 0.5f}, tri->screen_space.p0,
+                                                   tri->screen_space.p1, tri->screen_space.p2) &&
+                             IsPointInsideTriangle({(f32)x1 - 0.5f, (f32)y1 - 0.5f}, tri->screen_space.p0,
+                                                   tri->screen_space.p1, tri->screen_space.p2);
+
+    if (tile.state == DepthTileState::Decompressed) {
+        size_t pass_count = 0;
+        for (s32 y = y0; y < y1; ++y) {
+            for (s32 x = x0; x < x1; ++x) {
+                vec2f sample{(f32)x + 0.5f, (f32)y + 0.5f};
+                f32 E01 = EvaluateEdge(sample, tri->screen_space.p0, tri->screen_space.p1);
+                f32 E12 = EvaluateEdge(sample, tri->screen_space.p1, tri->screen_space.p2);
+                f32 E20 = EvaluateEdge(sample, tri->screen_space.p2, tri->screen_space.p0);
+                if (E01 > 0.0f || E12 > 0.0f || E20 > 0.0f)
+                    continue;
+
+                u32 depth = EncodeDepth(depth_buffer->format, EvaluateDepthPlane(plane, x, y));
+                u32 stored_depth = LoadDepth(depth_buffer, x, y);
+                bool const passes = writes_depth ? depth >= stored_depth : depth == stored_depth;
+                if (!passes)
+                    continue;
+
+                if constexpr (writes_depth) {
+                    StoreDepth(depth_buffer, x, y, depth);
+                    ++pass_count;
+                }
+                if constexpr (writes_color) {
+                    ShadeTrianglePixel(renderer, tri, parallelogram_area, x, y, E01, E12, E20);
+                }
+            }
+        }
+
+        // Won every pixel, back to a single plane.
+        if (writes_depth && covers_tile && depth_buffer->is_compression_enabled &&
+            pass_count == (size_t)(x1 - x0) * (y1 - y0)) {
+            tile.state = DepthTileState::OnePlane;
+            tile.planes[0] = plane;
+        }
+        return;
+    }
+
+    if (covers_tile) {
+        bool shades_tile = false;
+        if constexpr (writes_depth) {
+            s32 const comparison =
+                CompareToDepthTile(tile, depth_buffer->format, plane, tile_x0, tile_y0, tile_x1, tile_y1);
+            if (comparison < 0)
+                return;
+            shades_tile = comparison > 0;
+        } else {
+            // The prepass left exactly this triangle's plane in the tile.
+            shades_tile = tile.state == DepthTileState::OnePlane && IsSameDepthPlane(tile.planes[0], plane);
+        }
+
+        if (shades_tile) {
+            if constexpr (writes_color) {
+                for (s32 y = y0; y < y1; ++y) {
+                    for (s32 x = x0; x < x1; ++x) {
+                        vec2f sample{(f32)x + 0.5f, (f32)y + 0.5f};
+                        f32 E01 = EvaluateEdge(sample, tri->screen_space.p0, tri->screen_space.p1);
+                        f32 E12 = EvaluateEdge(sample, tri->screen_space.p1, tri->screen_space.p2);
+                        f32 E20 = EvaluateEdge(sample, tri->screen_space.p2, tri->screen_space.p0);
+                        ShadeTrianglePixel(renderer, tri, parallelogram_area, x, y, E01, E12, E20);
+                    }
+                }
+            }
+            if constexpr (writes_depth) {
+                tile.state = DepthTileState::OnePlane;
+                tile.planes[0] = plane;
+            }
+            return;
+        }
+    }
+
+    // Partial coverage or intersecting planes, test pixel by pixel against the compressed depth.
+    u16 write_mask[DEPTH_TILE_SIZE] = {};
+    for (s32 y = y0; y < y1; ++y) {
+        for (s32 x = x0; x < x1; ++x) {
+            vec2f sample{(f32)x + 0.5f, (f32)y + 0.5f};
+            f32 E01 = EvaluateEdge(sample, tri->screen_space.p0, tri->screen_space.p1);
+            f32 E12 = EvaluateEdge(sample, tri->screen_space.p1, tri->screen_space.p2);
+            f32 E20 = EvaluateEdge(sample, tri->screen_space.p2, tri->screen_space.p0);
+            if (E01 > 0.0f || E12 > 0.0f || E20 > 0.0f)
+                continue;
+
+            // Quantized like a Decompressed tile would store it, so compression doesn't change the result.
+            u32 depth = EncodeDepth(depth_buffer->format, EvaluateDepthPlane(plane, x, y));
+            u32 stored_depth = EncodeDepth(depth_buffer->format, GetCompressedDepth(tile, x, y));
+            bool const passes = writes_depth ? depth >= stored_depth : depth == stored_depth;
+            if (!passes)
+                continue;
+
+            if constexpr (writes_depth) {
+                write_mask[(size_t)y - tile_y0] |= (u16)(1u << ((size_t)x - tile_x0));
+            }
+            if constexpr (writes_color) {
+                ShadeTrianglePixel(renderer, tri, parallelogram_area, x, y, E01, E12, E20);
+            }
+        }
+    }
+
+    if constexpr (writes_depth) {
+        UpdateCompressedDepthTile(depth_buffer, tile_index, plane, write_mask);
+    }
+}
+
+template <DrawMode mode>
+static void DrawTriangleDepthTiles(Renderer* renderer, InterpolatedTriangle const* tri, DepthPlane const& plane,
+                                   f32 parallelogram_area, s32 x_min, s32 y_min, s32 x_max, s32 y_max) {
+    // One depth tile at a time, so tiles the triangle fully covers can stay compressed.
+    s32 const tile_size = (s32)DEPTH_TILE_SIZE;
+    for (s32 tile_y = y_min - y_min % tile_size; tile_y <= y_max; tile_y += tile_size) {
+        for (s32 tile_x = x_min - x_min % tile_size; tile_x <= x_max; tile_x += tile_size) {
+            DrawTriangleDepthTile<mode>(renderer, tri, plane, parallelogram_area, std::max(x_min, tile_x),
+                                        std::max(y_min, tile_y), std::min(x_max + 1, tile_x + tile_size),
+                                        std::min(y_max + 1, tile_y + tile_size));
+        }
+    }
+}
+
+void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle const* tri, vec2i const& clip_min, vec2i const& clip_max,
+                    DrawMode mode) {
     // tri AABB
     vec2f origin, size;
     GetTriangleAABB(tri->screen_space.p0, tri->screen_space.p1, tri->screen_space.p2, origin, size);
     // origin + size
     vec2f origin_plus_size = origin + size;
-    // Go over the triangle rect.
-    for (u32 y = (u32)(origin.y - 0.5f); y <= (u32)origin_plus_size.y; ++y) {
-        for (u32 x = (u32)(origin.x - 0.5f); x <= (u32)origin_plus_size.x; ++x) {
-            vec2f sample{(f32)x + 0.5f, (f32)y + 0.5f};
+    // Go over the pixels whose centers fall in the triangle rect, clipped to the given (exclusive max) rect.
+    s32 x_min = std::max(clip_min.x, (s32)std::ceil(origin.x - 0.5f));
+    s32 y_min = std::max(clip_min.y, (s32)std::ceil(origin.y - 0.5f));
+    s32 x_max = std::min(clip_max.x - 1, (s32)std::floor(origin_plus_size.x - 0.5f));
+    s32 y_max = std::min(clip_max.y - 1, (s32)std::floor(origin_plus_size.y - 0.5f));
+    if (x_min > x_max || y_min > y_max)
+        return;
+
+    f32 parallelogram_area = EvaluateEdge(tri->screen_space.p0, tri->screen_space.p1, tri->screen_space.p2);
+    if (parallelogram_area == 0.0f)
+        return;
+    DepthPlane const plane = GetTriangleDepthPlane(tri, parallelogram_area);
+
+    switch (mode) {
+    case DrawMode::Color:
+        DrawTriangleDepthTiles<DrawMode::Color>(renderer, tri, plane, parallelogram_area, x_min, y_min, x_max, y_max);
+        break;
+    case DrawMode::DepthOnly:
+        DrawTriangleDepthTiles<DrawMode::DepthOnly>(renderer, tri, plane, parallelogram_area, x_min, y_min, x_max,
+                                                    y_max);
+        break;
+    case DrawMode::ColorEqualDepth:
+        DrawTriangleDepthTiles<DrawMode::ColorEqualDepth>(renderer, tri, plane, parallelogram_area, x_min, y_min, x_max,
+                                                          y_max);
+        break;
+    case DrawMode::Wireframe:
+        // Edges are drawn from clip space by DrawMeshWireframe, a set-up triangle has already lost its near clipping.
+        break;
+    }
+}
 
-            if (x >= renderer->buffer_width || y >= renderer->buffer_height)
-                continue;
+#ifdef GFX_SSE2
+// Rasterizes up to SMALL_TRIANGLE_BATCH_SIZE small triangles, one per SSE lane. Setup, coverage, depth and color of
+// every candidate pixel are computed for all of them at once with the same arithmetic as DrawTriangle3D, then the
+// covered pixels are depth tested and written one triangle at a time so the result matches drawing them in order.
+// Depth tests compare encoded values whether a tile is compressed or not, so decompressing the tiles this path writes
+// doesn't change the image in any depth format.
+template <DrawMode mode>
+static void DrawSmallTriangles(Renderer* renderer, InterpolatedTriangle const* const* triangles, u32 count,
+                               vec2i const& clip_min, vec2i const& clip_max) {
+    constexpr bool writes_color = mode != DrawMode::DepthOnly;
+    constexpr bool writes_depth = mode != DrawMode::ColorEqualDepth;
+    constexpr u32 sample_count = (u32)(SMALL_TRIANGLE_SAMPLE_SPAN * SMALL_TRIANGLE_SAMPLE_SPAN);
+
+    // Unused lanes repeat the first triangle and are masked out.
+    InterpolatedTriangle const* lanes[SMALL_TRIANGLE_BATCH_SIZE];
+    for (u32 lane = 0; lane < SMALL_TRIANGLE_BATCH_SIZE; ++lane) {
+        lanes[lane] = triangles[lane < count ? lane : 0];
+    }
 
-            f32 E01 = EvaluateEdge(sample, tri->screen_space.p0, tri->screen_space.p1);
-            f32 E12 = EvaluateEdge(sample, tri->screen_space.p1, tri->screen_space.p2);
-            f32 E20 = EvaluateEdge(sample, tri->screen_space.p2, tri->screen_space.p0);
+#define GATHER_LANES(field) _mm_set_ps(lanes[3]->field, lanes[2]->field, lanes[1]->field, lanes[0]->field)
+    __m128 const p0x = GATHER_LANES(screen_space.p0.x);
+    __m128 const p0y = GATHER_LANES(screen_space.p0.y);
+    __m128 const p1x = GATHER_LANES(screen_space.p1.x);
+    __m128 const p1y = GATHER_LANES(screen_space.p1.y);
+    __m128 const p2x = GATHER_LANES(screen_space.p2.x);
+    __m128 const p2y = GATHER_LANES(screen_space.p2.y);
+    __m128 const w0 = GATHER_LANES(v0_pw_rcp);
+    __m128 const w1 = GATHER_LANES(v1_pw_rcp);
+    __m128 const w2 = GATHER_LANES(v2_pw_rcp);
+    __m128 const sample_x = _mm_add_ps(
+        _mm_cvtepi32_ps(_mm_set_epi32(lanes[3]->sample_x, lanes[2]->sample_x, lanes[1]->sample_x, lanes[0]->sample_x)),
+        _mm_set1_ps(0.5f));
+    __m128 const sample_y = _mm_add_ps(
+        _mm_cvtepi32_ps(_mm_set_epi32(lanes[3]->sample_y, lanes[2]->sample_y, lanes[1]->sample_y, lanes[0]->sample_y)),
+        _mm_set1_ps(0.5f));
+
+    // Edge vectors, EvaluateEdge(p, v0, v1) = (v1 - v0).x * (p - v0).y - (v1 - v0).y * (p - v0).x
+    __m128 const e01x = _mm_sub_ps(p1x, p0x);
+    __m128 const e01y = _mm_sub_ps(p1y, p0y);
+    __m128 const e12x = _mm_sub_ps(p2x, p1x);
+    __m128 const e12y = _mm_sub_ps(p2y, p1y);
+    __m128 const e20x = _mm_sub_ps(p0x, p2x);
+    __m128 const e20y = _mm_sub_ps(p0y, p2y);
+    __m128 const area = _mm_sub_ps(_mm_mul_ps(e12x, _mm_sub_ps(p0y, p1y)), _mm_mul_ps(e12y, _mm_sub_ps(p0x, p1x)));
+
+    // GetTriangleDepthPlane
+    __m128 const sign_bit = _mm_set1_ps(-0.0f);
+    __m128 const plane_a = _mm_div_ps(
+        _mm_xor_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e12y, w0), _mm_mul_ps(e20y, w1)), _mm_mul_ps(e01y, w2)), sign_bit),
+        area);
+    __m128 const plane_b =
+        _mm_div_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e12x, w0), _mm_mul_ps(e20x, w1)), _mm_mul_ps(e01x, w2)), area);
+    __m128 const plane_c = _mm_sub_ps(_mm_sub_ps(w0, _mm_mul_ps(plane_a, p0x)), _mm_mul_ps(plane_b, p0y));
+
+    // Degenerate triangles cover nothing.
+    s32 const lane_mask = ((1 << count) - 1) & ~_mm_movemask_ps(_mm_cmpeq_ps(area, _mm_setzero_ps()));
+
+    alignas(16) f32 depths[sample_count][SMALL_TRIANGLE_BATCH_SIZE];
+    alignas(16) u32 colors[sample_count][SMALL_TRIANGLE_BATCH_SIZE];
+    s32 coverage[sample_count];
+    for (u32 sample = 0; sample < sample_count; ++sample) {
+        __m128 const x = _mm_add_ps(sample_x, _mm_set1_ps((f32)(sample % SMALL_TRIANGLE_SAMPLE_SPAN)));
+        __m128 const y = _mm_add_ps(sample_y, _mm_set1_ps((f32)(sample / SMALL_TRIANGLE_SAMPLE_SPAN)));
+        __m128 const E01 = _mm_sub_ps(_mm_mul_ps(e01x, _mm_sub_ps(y, p0y)), _mm_mul_ps(e01y, _mm_sub_ps(x, p0x)));
+        __m128 const E12 = _mm_sub_ps(_mm_mul_ps(e12x, _mm_sub_ps(y, p1y)), _mm_mul_ps(e12y, _mm_sub_ps(x, p1x)));
+        __m128 const E20 = _mm_sub_ps(_mm_mul_ps(e20x, _mm_sub_ps(y, p2y)), _mm_mul_ps(e20y, _mm_sub_ps(x, p2x)));
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const inside =
+            _mm_and_ps(_mm_and_ps(_mm_cmple_ps(E01, zero), _mm_cmple_ps(E12, zero)), _mm_cmple_ps(E20, zero));
+        coverage[sample] = _mm_movemask_ps(inside) & lane_mask;
+        if (coverage[sample] == 0)
+            continue;
 
-            // @TODO: check inside-outside with tie-breaking rules
-            bool is_point_inside_triangle = E01 <= 0.0f && E12 <= 0.0f && E20 <= 0.0f;
+        _mm_store_ps(depths[sample],
+                     _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_a, x), _mm_mul_ps(plane_b, y)), plane_c));
+
+        if constexpr (writes_color) {
+            // ShadeTrianglePixel, the perspective divide is one division for all lanes.
+            __m128 const lambda0 = _mm_div_ps(E12, area);
+            __m128 const lambda1 = _mm_div_ps(E20, area);
+            __m128 const lambda2 = _mm_div_ps(E01, area);
+            __m128 const rcp_pw_interp =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(lambda0, w0), _mm_mul_ps(lambda1, w1)), _mm_mul_ps(lambda2, w2));
+            __m128i pixel = _mm_set1_epi32((s32)0xFF000000);
+            for (u32 channel = 0; channel < 3; ++channel) {
+                __m128 const c0 = GATHER_LANES(attributes_w.v0_color[channel]);
+                __m128 const c1 = GATHER_LANES(attributes_w.v1_color[channel]);
+                __m128 const c2 = GATHER_LANES(attributes_w.v2_color[channel]);
+                __m128 const value = _mm_div_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(lambda0, c0), _mm_mul_ps(lambda1, c1)), _mm_mul_ps(lambda2, c2)),
+                    rcp_pw_interp);
+                // PutPixel's conversion, R goes to bits 16-23 and B to 0-7.
+                __m128i const channel_8bpc =
+                    _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(value, _mm_set1_ps(255.0f))), _mm_set1_epi32(0xFF));
+                pixel = _mm_or_si128(pixel, _mm_slli_epi32(channel_8bpc, (s32)(16 - 8 * channel)));
+            }
+            _mm_store_si128(reinterpret_cast<__m128i*>(colors[sample]), pixel);
+        }
+    }
+#undef GATHER_LANES
 
-            if (is_point_inside_triangle) {
-                f32 parallelogram_area = EvaluateEdge(tri->screen_space.p0, tri->screen_space.p1, tri->screen_space.p2);
-                // Barycentric coordinates
-                f32 lambda0 = E12 / parallelogram_area;
-                f32 lambda1 = E20 / parallelogram_area;
-                f32 lambda2 = E01 / parallelogram_area;
+    DepthBuffer* depth_buffer = &renderer->depth_buffer;
+    for (u32 lane = 0; lane < count; ++lane) {
+        for (u32 sample = 0; sample < sample_count; ++sample) {
+            if (((coverage[sample] >> lane) & 1) == 0)
+                continue;
 
-                // 1/P~w interpolated
-                f32 rcp_pw_interp = lambda0 * tri->v0_pw_rcp + lambda1 * tri->v1_pw_rcp + lambda2 * tri->v2_pw_rcp;
+            s32 const x = lanes[lane]->sample_x + (s32)(sample % SMALL_TRIANGLE_SAMPLE_SPAN);
+            s32 const y = lanes[lane]->sample_y + (s32)(sample / SMALL_TRIANGLE_SAMPLE_SPAN);
+            if (x < clip_min.x || y < clip_min.y || x >= clip_max.x || y >= clip_max.y)
+                continue;
 
-                // 1/z
-                f32* w_at_pixel = &renderer->w_buffer[y * renderer->buffer_width + x];
+            // Same tests as DrawTriangleDepthTile. A tile takes too many small triangles to stay compressed, written
+            // tiles are decompressed.
+            u32 const encoded_depth = EncodeDepth(depth_buffer->format, depths[sample][lane]);
+            size_t const tile_index = GetDepthTileIndex(depth_buffer, x, y);
+            DepthTile const& tile = depth_buffer->tiles[tile_index];
+            u32 const stored_depth = tile.state == DepthTileState::Decompressed
+                                         ? LoadDepth(depth_buffer, x, y)
+                                         : EncodeDepth(depth_buffer->format, GetCompressedDepth(tile, x, y));
+            bool const passes = writes_depth ? encoded_depth >= stored_depth : encoded_depth == stored_depth;
+            if (!passes)
+                continue;
 
-                if (rcp_pw_interp >= *w_at_pixel) {
-                    *w_at_pixel = rcp_pw_interp;
-                    vec3f color_interp = lambda0 * tri->attributes_w.v0_color + lambda1 * tri->attributes_w.v1_color +
-                                         lambda2 * tri->attributes_w.v2_color;
-                    color_interp = color_interp / rcp_pw_interp;
-                    PutPixel(renderer, x, y, color_interp);
-                }
+            if constexpr (writes_depth) {
+                DecompressDepthTile(depth_buffer, tile_index);
+                StoreDepth(depth_buffer, x, y, encoded_depth);
+            }
+            if constexpr (writes_color) {
+                PutPixel(renderer, x, y, colors[sample][lane]);
             }
         }
     }
 }
+#endif
+
+// Draws the triangles in order, runs of small triangles a batch at a time.
+static void DrawTriangles(Renderer* renderer, InterpolatedTriangle const* const* triangles, u32 count,
+                          vec2i const& clip_min, vec2i const& clip_max, DrawMode mode) {
+    u32 index = 0;
+    while (index < count) {
+#ifdef GFX_SSE2
+        u32 run = 0;
+        while (run < SMALL_TRIANGLE_BATCH_SIZE && index + run < count && triangles[index + run]->is_small) {
+            ++run;
+        }
+        if (run > 0) {
+            switch (mode) {
+            case DrawMode::Color:
+                DrawSmallTriangles<DrawMode::Color>(renderer, triangles + index, run, clip_min, clip_max);
+                break;
+            case DrawMode::DepthOnly:
+                DrawSmallTriangles<DrawMode::DepthOnly>(renderer, triangles + index, run, clip_min, clip_max);
+                break;
+            case DrawMode::ColorEqualDepth:
+                DrawSmallTriangles<DrawMode::ColorEqualDepth>(renderer, triangles + index, run, clip_min, clip_max);
+                break;
+            case DrawMode::Wireframe:
+                // Never binned.
+                break;
+            }
+            index += run;
+            continue;
+        }
+#endif
+        DrawTriangle3D(renderer, triangles[index], clip_min, clip_max, mode);
+        ++index;
+    }
+}
 
 void CleanupRenderer(Renderer* renderer) {
-
-    if (renderer->color_buffer != nullptr) {
-        delete[] renderer->color_buffer;
+    WaitForRenderer(renderer);
+    if (renderer->is_framebuffer_locked) {
+        SDL_UnlockTexture(renderer->framebuffer);
+        renderer->is_framebuffer_locked = false;
     }
 
-    if (renderer->w_buffer != nullptr) {
-        delete[] renderer->w_buffer;
+    ShutdownJobSystem(&renderer->job_system);
+    for (FrameSlot& slot : renderer->frame_slots) {
+        for (FrameArena& arena : slot.frame_arenas) {
+            DestroyFrameArena(&arena);
+        }
     }
 
-    if (renderer->clear_w_buffer != nullptr) {
-        delete[] renderer->clear_w_buffer;
+    if (renderer->cpu_color_buffer != nullptr) {
+        delete[] renderer->cpu_color_buffer;
+    }
+    if (renderer->upscaled_color_buffer != nullptr) {
+        delete[] renderer->upscaled_color_buffer;
     }
 
-    if (renderer->framebuffer != nullptr) {
-        SDL_DestroyTexture(renderer->framebuffer);
+    DestroyDepthBuffer(&renderer->depth_buffer);
+
+    for (SDL_Texture* framebuffer : renderer->framebuffers) {
+        if (framebuffer != nullptr) {
+            SDL_DestroyTexture(framebuffer);
+        }
     }
 
     if (renderer->sdl_renderer != nullptr) {
@@ -16,6 +16,9 @@
 #include "imgui_impl_sdlrenderer.h"
 #include "logger.h"
 
+#include "depth_buffer.h"
+#include "frame_arena.h"
+#include "job_system.h"
 #include "mesh.h"
 #include "types.h"
 #include <glm/ext/matrix_clip_space.hpp>
@@ -27,6 +30,17 @@ namespace gfx {
 
 static size_t constexpr L0_TILE_SIZE = 128;
 static size_t constexpr L1_TILE_SIZE = 16;
+// Depth is compressed per L1 tile and L0 tiles are rasterized in parallel, so every L1 tile belongs to one L0 tile.
+static_assert(L1_TILE_SIZE == DEPTH_TILE_SIZE && L0_TILE_SIZE % L1_TILE_SIZE == 0);
+// Instances a worker transforms and bins before going back for more.
+static size_t constexpr INSTANCE_BATCH_SIZE = 16;
+static u32 constexpr TILE_BIN_CHUNK_SIZE = 64;
+// Triangles whose pixel centers fit in a block this many pixels wide and high take the small triangle kernel, which
+// rasterizes this many of them at once, one per SSE lane.
+static s32 constexpr SMALL_TRIANGLE_SAMPLE_SPAN = 2;
+static u32 constexpr SMALL_TRIANGLE_BATCH_SIZE = 4;
+// Frames whose binning state is live at once, frame N + 1 is binned while frame N is rasterized.
+static u32 constexpr FRAME_SLOT_COUNT = 2;
 
 static constexpr u8 CORNER_VERTICAL_BIT   = (1 << 0);
 static constexpr u8 CORNER_HORIZONTAL_BIT = (1 << 1);
@@ -62,18 +76,153 @@ struct Triangle2D {
     vec2f vtx_pos1 = vec2f(0.0f);
     vec2f vtx_pos2 = vec2f(0.0f);
 
-    std::string debug_name = "Triangle";
+    char const* debug_name = "Triangle";
+};
+
+struct InterpolatedTriangle {
+    InterpolatedTriangle() = default;
+
+    struct {
+        vec2f p0;
+        vec2f p1;
+        vec2f p2;
+    } screen_space;
+
+    f32 v0_pw_rcp = 1.0f;
+    f32 v1_pw_rcp = 1.0f;
+    f32 v2_pw_rcp = 1.0f;
+
+    struct {
+        vec3f v0_color;
+        vec3f v1_color;
+        vec3f v2_color;
+    } attributes_w;
+
+    // Set when binning. A small triangle's candidate pixels are the SMALL_TRIANGLE_SAMPLE_SPAN square block with its
+    // top-left pixel at (sample_x, sample_y).
+    bool is_small = false;
+    s32 sample_x = 0;
+    s32 sample_y = 0;
+};
+
+// Submission order of binned triangles: the draw's index in its frame slot, then the instance batch.
+__forceinline u64 GetBinSequence(u32 draw_index, size_t first_instance) {
+    return ((u64)draw_index << 32) | (u64)(first_instance / INSTANCE_BATCH_SIZE);
+}
+
+// Triangles binned to one L0 tile, in chunks allocated from a frame arena. A chunk holds triangles of one instance
+// batch, in the order they were set up.
+struct TileBinChunk {
+    TileBinChunk* next;
+    u64 sequence;
+    u32 count;
+    InterpolatedTriangle const* triangles[TILE_BIN_CHUNK_SIZE];
+};
+
+// Chunks sorted by sequence. Workers pick batches in whatever order they get them, so a batch's chunks aren't always
+// appended at the end.
+struct TileBin {
+    TileBinChunk* first;
+    TileBinChunk* last;
+    // Where the batch being binned goes.
+    TileBinChunk* current;
+};
+
+enum class DrawMode : u8 {
+    // Depth test GREATER_EQUAL, writes depth and color.
+    Color,
+    // Writes depth only. No attribute setup or shading.
+    DepthOnly,
+    // Depth test EQUAL without depth writes. Run after a DepthOnly pass of the same geometry, each pixel is shaded
+    // once.
+    ColorEqualDepth,
+    // Triangle edges as lines (lines.h), depth tested against what's already drawn without depth writes. Drawn
+    // immediately instead of binned, so it's skipped when pipelined.
+    Wireframe
+};
+// Modes that go through the tile bins, all but Wireframe.
+static constexpr u32 BINNED_DRAW_MODE_COUNT = 3;
+
+// Per-worker output of the transform/setup/binning stage.
+struct BinningContext {
+    // One bin per L0 tile and draw mode, allocated from the worker's frame arena when it bins its first triangle of a
+    // draw. A tile merges the bins of every mode and context back into submission order, so the image is the one
+    // immediate drawing would give and doesn't depend on which worker binned what. A depth prepass has to be submitted
+    // before its color pass.
+    TileBin* tile_bins[BINNED_DRAW_MODE_COUNT] = {};
+};
+
+// Command/binning state of one frame.
+struct FrameSlot {
+    // One per job worker. Arenas hold every transient allocation of the frame and are reset when the slot is reused.
+    std::vector<BinningContext> binning_contexts;
+    std::vector<FrameArena> frame_arenas;
+    // Draws binned since the bins were last reset, the next draw's index.
+    u32 draw_count = 0;
+};
+
+enum class PresentMode : u8 {
+    // Rasterize into a CPU buffer and copy it into the streaming texture with SDL_UpdateTexture.
+    Copy,
+    // Rasterize straight into the locked streaming texture, no full-frame copy.
+    LockedTexture
+};
+
+// Horizontal bilinear taps of one framebuffer column when upscaling, `weight` is x1's share out of
+// UPSCALE_WEIGHT_ONE.
+struct UpscaleTap {
+    u32 x0;
+    u32 x1;
+    u32 weight;
+};
+static constexpr u32 UPSCALE_WEIGHT_SHIFT = 7;
+static constexpr u32 UPSCALE_WEIGHT_ONE = 1u << UPSCALE_WEIGHT_SHIFT;
+
+// How much of the previous frame a new frame keeps.
+enum class FrameUpdate : u8 {
+    // Clear and redraw everything.
+    Full,
+    // Clear and re-rasterize only the L0 tiles marked with MarkDirtyRect, the rest keep last frame's color and depth.
+    DirtyTiles,
+    // Nothing changed, present the previous image again without clearing, binning or rasterizing.
+    Reuse
+};
+
+struct RendererSettings {
+    // 0 = one job worker per hardware thread
+    u32 worker_count = 0;
+    bool pin_workers_to_cores = false;
+    PresentMode present_mode = PresentMode::LockedTexture;
+    // Present without waiting for vsync, the next frame starts while the previous one is being displayed.
+    bool async_present = false;
+    // Bin draws of frame N + 1 while frame N is still being rasterized. Draws are deferred to Present and the image
+    // trails the caller by a frame.
+    bool pipelined = false;
+    DepthFormat depth_format = DepthFormat::Float32;
+    // Keep L1 tiles covered by up to two triangles as plane equations instead of per-pixel depth.
+    bool compress_depth = true;
+    // Allow SetFrameUpdate to keep parts or all of the previous frame.
+    bool incremental = false;
+    // Allow SetRenderResolution to render below the window size, Present upscales the frame to fill the window. Not
+    // available when pipelined.
+    bool dynamic_resolution = false;
 };
 
 struct Renderer {
+    // Streaming texture of the current frame, one of `framebuffers`.
     SDL_Texture* framebuffer = nullptr;
     f32 aspect_ratio = 800.0f / 600.0f;
     s32 color_buffer_pitch = 0;
     SDL_Renderer* sdl_renderer = nullptr;
+    // Render target of the current frame, either cpu_color_buffer or the locked framebuffer memory.
     u32* color_buffer = nullptr;
-    f32* w_buffer = nullptr;
-    f32* clear_w_buffer = nullptr;
+    // Row stride of color_buffer in pixels, follows the texture pitch when rasterizing into the locked framebuffer.
+    size_t color_buffer_stride = 0;
+    // Window sized, rows are max_buffer_width pixels apart whatever the render resolution.
+    u32* cpu_color_buffer = nullptr;
+    DepthBuffer depth_buffer;
 
+    // Render resolution, the top-left part of the window sized buffers that is rasterized.
     size_t buffer_width = 0;
     size_t buffer_height = 0;
     size_t buffer_size_in_pixels = 0;
@@ -81,51 +230,116 @@ struct Renderer {
     f32 fBuffer_heigth = 0.0f;
     // In bytes
     size_t color_buffer_size_in_bytes = 0;
-    size_t w_buffer_size_in_bytes = 0;
+    // Window size, what the buffers and framebuffers are allocated for.
+    size_t max_buffer_width = 0;
+    size_t max_buffer_height = 0;
+
+    // Dynamic resolution
+    bool is_resolution_dynamic = false;
+    // Window sized target of the upscale when the framebuffer can't be locked.
+    u32* upscaled_color_buffer = nullptr;
+    // One per framebuffer column, rebuilt when the render resolution changes.
+    std::vector<UpscaleTap> upscale_taps;
 
     // Tile
     std::vector<Tile> l0_tiles;
     size_t l0_tile_count_pitch = 0;
     size_t l0_tile_count = 0;
+    // Non-zero for L0 tiles that are re-rasterized when frame_update is DirtyTiles.
+    std::vector<u8> dirty_l0_tiles;
+
+    // Present
+    PresentMode present_mode = PresentMode::LockedTexture;
+    bool async_present = false;
+    // Two textures when presenting asynchronously or pipelined so the next frame never locks the one still being
+    // displayed.
+    SDL_Texture* framebuffers[2] = {};
+    u32 framebuffer_count = 1;
+    u32 framebuffer_index = 0;
+    bool is_framebuffer_locked = false;
+    // Texture shown by the last Present, null before the first frame.
+    SDL_Texture* presented_framebuffer = nullptr;
+    // Whether the color and depth buffers still hold the presented frame at the current resolution.
+    bool has_previous_frame = false;
+
+    // Incremental rendering
+    bool is_incremental = false;
+    // Reset to Full by every Present.
+    FrameUpdate frame_update = FrameUpdate::Full;
+
+    // Persistent workers shared by every stage.
+    JobSystem job_system;
+    // Only slot 0 is used unless pipelined.
+    FrameSlot frame_slots[FRAME_SLOT_COUNT];
+    // Slot this frame's draws are binned into.
+    u32 frame_slot_index = 0;
+
+    // Pipelining
+    bool is_pipelined = false;
+    // Joins the raster jobs of the frame in flight, null when nothing is in flight.
+    Job* raster_job = nullptr;
 };
 
-struct InterpolatedTriangle {
-    InterpolatedTriangle() = default;
-
-    struct {
-        vec2f p0;
-        vec2f p1;
-        vec2f p2;
-    } screen_space;
-
-    f32 v0_pw_rcp = 1.0f;
-    f32 v1_pw_rcp = 1.0f;
-    f32 v2_pw_rcp = 1.0f;
-
-    struct {
-        vec3f v0_color;
-        vec3f v1_color;
-        vec3f v2_color;
-    } attributes_w;
-};
 
 void InitImGui(SDL_Window* wnd, SDL_Renderer* renderer);
-bool InitRenderer(SDL_Window* window, Renderer* renderer);
+bool InitRenderer(SDL_Window* window, Renderer* renderer, RendererSettings const& settings = {});
+// Renderer without a window, frames stay in cpu_color_buffer and the depth buffer. Present must not be called.
+bool InitHeadlessRenderer(Renderer* renderer, size_t width, size_t height, RendererSettings const& settings = {});
 void CleanupRenderer(Renderer* renderer);
+// Points color_buffer at this frame's render target. Called by ClearBuffers.
+bool AcquireColorBuffer(Renderer* renderer);
+// Call before ClearBuffers, starts an empty dirty set. Falls back to Full whenever the previous frame can't be kept:
+// incremental rendering is off, the frame is pipelined, nothing has been presented at this resolution yet, or
+// (DirtyTiles) the color buffer doesn't survive the present because it's the locked texture.
+void SetFrameUpdate(Renderer* renderer, FrameUpdate update);
+// Marks the L0 tiles overlapping the raster-space rect for a DirtyTiles frame.
+void MarkDirtyRect(Renderer* renderer, vec2f const& min, vec2f const& max);
+// Call between frames, before ClearBuffers. Clamped to the window size, the next frame is a full redraw. False when
+// dynamic resolution isn't enabled.
+bool SetRenderResolution(Renderer* renderer, size_t width, size_t height);
+// SetRenderResolution with both sides of the window scaled by `scale`.
+bool SetRenderScale(Renderer* renderer, f32 scale);
 void ClearBuffers(Renderer* renderer);
+// Pipelined: finishes and shows the previous frame, then starts rasterizing this one without waiting for it.
 void Present(Renderer* renderer);
+// Blocks until the frame in flight has been rasterized, a no-op unless pipelined.
+void WaitForRenderer(Renderer* renderer);
+// Immediate-mode drawing (PutPixel, DrawRect, DrawTriangle2D/3D, the tile debug views, lines.h and overlay.h) writes
+// the color buffer right away and must not be used while pipelined, the previous frame may still be rasterizing into
+// it.
 void PutPixel(Renderer* renderer, u32 x, u32 y, uint32_t color);
 void PutPixel(Renderer* renderer, u32 x, u32 y, vec3f const& color);
 
 Corner GetTrivialRejectCorner(f32 A, f32 B);
+// Labels every L0 tile with how the triangle classifies against it (trivial reject / accept) over the tile grid.
 u64 BinTriangle2D_L0(Renderer* renderer, Triangle2D* triangle);
 void GenerateL0Tiles(Renderer* renderer, size_t tile_size = L0_TILE_SIZE);
 void DrawTileGrid(Renderer* renderer);
+// Filled, clipped to the render resolution.
 void DrawRect(Renderer* renderer, s32 x0, s32 y0, s32 w, s32 h, u32 color);
 void DrawRect(Renderer* renderer, vec2i const& position, vec2i const& size, u32 color);
+// Untested against depth, meant to go under the scene. Only the L0 tiles this frame redraws are written.
 void DrawTriangle2D(Renderer* renderer, Triangle2D* tri);
-void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle* tri);
-void DrawMesh(Renderer* renderer, Mesh* mesh, glm::mat4 const& mvp);
+void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle const* tri, DrawMode mode = DrawMode::Color);
+void DrawTriangle3D(Renderer* renderer, InterpolatedTriangle const* tri, vec2i const& clip_min, vec2i const& clip_max,
+                    DrawMode mode = DrawMode::Color);
+// Screen-space positions and 1/w only, enough for DrawMode::DepthOnly.
+bool SetupTrianglePositions(Renderer* renderer, vec4f const& v0_clip, vec4f const& v1_clip, vec4f const& v2_clip,
+                            InterpolatedTriangle* triangle);
+bool SetupInterpolatedTriangle(Renderer* renderer, vec4f const& v0_clip, vec4f const& v1_clip, vec4f const& v2_clip,
+                               InterpolatedTriangle* triangle);
+// Goes through DrawMeshInstanced when pipelined, or for Wireframe.
+void DrawMesh(Renderer* renderer, Mesh* mesh, glm::mat4 const& mvp, u32 lod = 0, DrawMode mode = DrawMode::Color);
+// Draws `instance_count` copies of the mesh. All instances are transformed and binned together, then rasterized
+// tile by tile. Wireframe draws every triangle's edges right away instead, one instance after the other.
+void DrawMeshInstanced(Renderer* renderer, Mesh* mesh, glm::mat4 const& view_projection, glm::mat4 const* transforms,
+                       size_t instance_count, u32 lod = 0, DrawMode mode = DrawMode::Color);
+
+// Rendering below the window size, the frame is upscaled by Present.
+__forceinline bool IsUpscaling(Renderer const* renderer) {
+    return renderer->buffer_width != renderer->max_buffer_width ||
+           renderer->buffer_height != renderer->max_buffer_height;
+}
 
 __forceinline constexpr u32 RGBA(u8 R, u8 G, u8 B, u8 A = 255) {
     return (u32)B | (u32)(G << 8) | (u32)(R << 16) | (u32)(A << 24);
@@ -0,0 +1,386 @@
+#include "scene.h"
+#include "mesh_lod.h"
+#include "renderer.h"
+#include <algorithm>
+
+namespace gfx {
+
+// Refitting never restructures the tree, rebuild when the inner nodes' summed area has grown past this factor of its
+// built value.
+static constexpr f32 BVH_REBUILD_AREA_RATIO = 2.0f;
+
+u32 AddMeshInstance(Scene* scene, Mesh* mesh, glm::mat4 const& transform) {
+    MeshInstance instance{};
+    instance.mesh = mesh;
+    instance.transform = transform;
+    instance.world_bounds = TransformAABB(mesh->bounds, transform);
+    instance.drawn_bounds = instance.world_bounds;
+    instance.drawn_mesh_version = mesh->version;
+    scene->instances.push_back(instance);
+    scene->bvh_needs_rebuild = true;
+    return (u32)(scene->instances.size() - 1);
+}
+
+void SetMeshInstanceTransform(Scene* scene, u32 instance_index, glm::mat4 const& transform) {
+    MeshInstance& instance = scene->instances[instance_index];
+    instance.transform = transform;
+    instance.world_bounds = TransformAABB(instance.mesh->bounds, transform);
+    scene->moved_instances.push_back(instance_index);
+}
+
+static u32 BuildBVHRecursive(Scene* scene, u32* indices, size_t count, u32 parent) {
+    u32 node_index = (u32)scene->bvh_nodes.size();
+    scene->bvh_nodes.emplace_back();
+    scene->bvh_nodes[node_index].parent = parent;
+
+    if (count == 1) {
+        MeshInstance& instance = scene->instances[indices[0]];
+        BVHNode& leaf = scene->bvh_nodes[node_index];
+        leaf.bounds = instance.world_bounds;
+        leaf.instance_index = indices[0];
+        instance.bvh_leaf = node_index;
+        return node_index;
+    }
+
+    // Median split along the largest axis of the centroid bounds.
+    AABB centroid_bounds{};
+    for (size_t i = 0; i < count; ++i) {
+        AABB const& b = scene->instances[indices[i]].world_bounds;
+        ExpandAABB(centroid_bounds, (b.min + b.max) * 0.5f);
+    }
+
+    vec3f extent = centroid_bounds.max - centroid_bounds.min;
+    int axis = 0;
+    if (extent.y > extent.x)
+        axis = 1;
+    if (extent.z > extent[axis])
+        axis = 2;
+
+    size_t mid = count / 2;
+    std::nth_element(indices, indices + mid, indices + count, [scene, axis](u32 a, u32 b) {
+        AABB const& ba = scene->instances[a].world_bounds;
+        AABB const& bb = scene->instances[b].world_bounds;
+        return (ba.min[axis] + ba.max[axis]) < (bb.min[axis] + bb.max[axis]);
+    });
+
+    u32 left = BuildBVHRecursive(scene, indices, mid, node_index);
+    u32 right = BuildBVHRecursive(scene, indices + mid, count - mid, node_index);
+
+    BVHNode& node = scene->bvh_nodes[node_index];
+    node.left = left;
+    node.right = right;
+    node.bounds = scene->bvh_nodes[left].bounds;
+    ExpandAABB(node.bounds, scene->bvh_nodes[right].bounds);
+    scene->bvh_inner_area += GetAABBSurfaceArea(node.bounds);
+    return node_index;
+}
+
+void BuildSceneBVH(Scene* scene) {
+    scene->bvh_nodes.clear();
+    scene->bvh_root = BVH_INVALID_INDEX;
+    scene->bvh_needs_rebuild = false;
+    scene->bvh_inner_area = 0.0f;
+    scene->bvh_built_inner_area = 0.0f;
+    scene->moved_instances.clear();
+
+    size_t const instance_count = scene->instances.size();
+    if (instance_count == 0)
+        return;
+
+    // A binary tree with one instance per leaf has exactly 2n - 1 nodes.
+    scene->bvh_nodes.reserve(2 * instance_count - 1);
+
+    std::vector<u32> indices(instance_count);
+    for (size_t i = 0; i < instance_count; ++i) {
+        indices[i] = (u32)i;
+    }
+
+    scene->bvh_root = BuildBVHRecursive(scene, indices.data(), instance_count, BVH_INVALID_INDEX);
+    scene->bvh_built_inner_area = scene->bvh_inner_area;
+}
+
+void RefitSceneBVH(Scene* scene) {
+    for (u32 instance_index : scene->moved_instances) {
+        MeshInstance const& instance = scene->instances[instance_index];
+        BVHNode* node = &scene->bvh_nodes[instance.bvh_leaf];
+        node->bounds = instance.world_bounds;
+
+        // Walk towards the root, stop as soon as a parent's bounds don't change (handles both growing and shrinking).
+        while (node->parent != BVH_INVALID_INDEX) {
+            BVHNode& parent = scene->bvh_nodes[node->parent];
+            AABB refit = scene->bvh_nodes[parent.left].bounds;
+            ExpandAABB(refit, scene->bvh_nodes[parent.right].bounds);
+
+            if (refit.min == parent.bounds.min && refit.max == parent.bounds.max)
+                break;
+
+            scene->bvh_inner_area += GetAABBSurfaceArea(refit) - GetAABBSurfaceArea(parent.bounds);
+            parent.bounds = refit;
+            node = &parent;
+        }
+    }
+    scene->moved_instances.clear();
+}
+
+void UpdateSceneBVH(Scene* scene) {
+    if (scene->bvh_needs_rebuild) {
+        BuildSceneBVH(scene);
+        return;
+    }
+
+    if (scene->moved_instances.empty())
+        return;
+
+    RefitSceneBVH(scene);
+
+    // The root alone misses instances that move apart inside it, every inner node that loosens adds to the sum.
+    if (scene->bvh_inner_area > scene->bvh_built_inner_area * BVH_REBUILD_AREA_RATIO) {
+        BuildSceneBVH(scene);
+    }
+}
+
+Frustum ExtractFrustum(glm::mat4 const& view_projection) {
+    // Gribb-Hartmann, glm is column-major so row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+    glm::mat4 const& m = view_projection;
+    vec4f row0 = {m[0][0], m[1][0], m[2][0], m[3][0]};
+    vec4f row1 = {m[0][1], m[1][1], m[2][1], m[3][1]};
+    vec4f row2 = {m[0][2], m[1][2], m[2][2], m[3][2]};
+    vec4f row3 = {m[0][3], m[1][3], m[2][3], m[3][3]};
+
+    Frustum frustum{};
+    frustum.planes[0] = row3 + row0; // Left
+    frustum.planes[1] = row3 - row0; // Right
+    frustum.planes[2] = row3 + row1; // Bottom
+    frustum.planes[3] = row3 - row1; // Top
+    frustum.planes[4] = row3 + row2; // Near
+    frustum.planes[5] = row3 - row2; // Far
+
+    for (vec4f& plane : frustum.planes) {
+        plane /= glm::length(vec3f(plane));
+    }
+    return frustum;
+}
+
+// Returns -1 if the box is fully outside the plane, 1 if fully inside and 0 if it straddles it.
+__forceinline static int ClassifyAABBPlane(vec4f const& plane, AABB const& aabb) {
+    // Corner furthest along the plane normal (p-vertex) and the one furthest against it (n-vertex).
+    vec3f p_vertex = {plane.x >= 0.0f ? aabb.max.x : aabb.min.x, plane.y >= 0.0f ? aabb.max.y : aabb.min.y,
+                      plane.z >= 0.0f ? aabb.max.z : aabb.min.z};
+    vec3f n_vertex = {plane.x >= 0.0f ? aabb.min.x : aabb.max.x, plane.y >= 0.0f ? aabb.min.y : aabb.max.y,
+                      plane.z >= 0.0f ? aabb.min.z : aabb.max.z};
+
+    if (glm::dot(vec3f(plane), p_vertex) + plane.w < 0.0f)
+        return -1;
+    if (glm::dot(vec3f(plane), n_vertex) + plane.w >= 0.0f)
+        return 1;
+    return 0;
+}
+
+static void CollectBVHLeaves(Scene* scene, u32 root) {
+    u32 stack[64];
+    size_t stack_size = 0;
+    stack[stack_size++] = root;
+
+    while (stack_size > 0) {
+        BVHNode const& node = scene->bvh_nodes[stack[--stack_size]];
+        if (node.left == BVH_INVALID_INDEX) {
+            scene->visible_instances.push_back(node.instance_index);
+            continue;
+        }
+        stack[stack_size++] = node.left;
+        stack[stack_size++] = node.right;
+    }
+}
+
+void CullScene(Scene* scene, Frustum const& frustum) {
+    scene->visible_instances.clear();
+    if (scene->bvh_root == BVH_INVALID_INDEX)
+        return;
+
+    // Each entry carries the set of planes the node still needs to be tested against. Once a box is fully inside a
+    // plane, none of its children can cross it.
+    struct StackEntry {
+        u32 node;
+        u8 plane_mask;
+    };
+
+    // Median splits keep the tree balanced, 64 levels is far more than we will ever have.
+    StackEntry stack[64];
+    size_t stack_size = 0;
+    stack[stack_size++] = {scene->bvh_root, 0b111111};
+
+    while (stack_size > 0) {
+        StackEntry entry = stack[--stack_size];
+        BVHNode const& node = scene->bvh_nodes[entry.node];
+
+        u8 plane_mask = entry.plane_mask;
+        bool is_outside = false;
+        for (u32 plane_index = 0; plane_index < 6; ++plane_index) {
+            u8 plane_bit = (u8)(1 << plane_index);
+            if ((plane_mask & plane_bit) == 0)
+                continue;
+
+            int classification = ClassifyAABBPlane(frustum.planes[plane_index], node.bounds);
+            if (classification < 0) {
+                is_outside = true;
+                break;
+            }
+            if (classification > 0) {
+                plane_mask &= ~plane_bit;
+            }
+        }
+
+        if (is_outside)
+            continue;
+
+        if (plane_mask == 0) {
+            // Fully inside, take the whole subtree.
+            CollectBVHLeaves(scene, entry.node);
+            continue;
+        }
+
+        if (node.left == BVH_INVALID_INDEX) {
+            scene->visible_instances.push_back(node.instance_index);
+            continue;
+        }
+
+        stack[stack_size++] = {node.left, plane_mask};
+        stack[stack_size++] = {node.right, plane_mask};
+    }
+}
+
+// Raster-space rect of world-space bounds. False when the bounds reach behind the near plane (w < 1), triangles there
+// are rejected and the projected rect means nothing.
+static bool GetScreenBounds(Renderer const* renderer, AABB const& bounds, glm::mat4 const& view_projection,
+                            vec2f& screen_min, vec2f& screen_max) {
+    screen_min = vec2f(FLT_MAX);
+    screen_max = vec2f(-FLT_MAX);
+    for (u32 corner = 0; corner < 8; ++corner) {
+        vec3f point = vec3f((corner & 1) ? bounds.max.x : bounds.min.x, (corner & 2) ? bounds.max.y : bounds.min.y,
+                            (corner & 4) ? bounds.max.z : bounds.min.z);
+        vec4f clip = view_projection * vec4f(point, 1.0f);
+        if (clip.w < 1.0f)
+            return false;
+
+        // Same mapping as SetupInterpolatedTriangle
+        vec2f screen = (vec2f(clip) / clip.w + vec2f(1.0f)) / 2.0f;
+        screen.y = 1.0f - screen.y;
+        screen = screen * vec2f(renderer->fBuffer_width, renderer->fBuffer_heigth);
+        screen_min = glm::min(screen_min, screen);
+        screen_max = glm::max(screen_max, screen);
+    }
+
+    // The rasterizer's bounds reach half a pixel further.
+    screen_min -= vec2f(1.0f);
+    screen_max += vec2f(1.0f);
+    return true;
+}
+
+void TrackSceneChanges(Renderer* renderer, Scene* scene, FlyingCameraController const* camera) {
+    glm::mat4 view_projection = get_flying_camera_projection(camera, renderer->aspect_ratio) * camera->view_transform;
+
+    // An edited mesh moves its instances' bounds just like a new transform.
+    for (u32 instance_index = 0; instance_index < (u32)scene->instances.size(); ++instance_index) {
+        MeshInstance const& instance = scene->instances[instance_index];
+        if (instance.mesh->version != instance.drawn_mesh_version) {
+            SetMeshInstanceTransform(scene, instance_index, instance.transform);
+        }
+    }
+
+    bool const is_view_unchanged = scene->has_drawn_frame && view_projection == scene->drawn_view_projection &&
+                                   scene->lod_pixel_error == scene->drawn_lod_pixel_error &&
+                                   scene->show_wireframe == scene->drawn_show_wireframe &&
+                                   scene->instances.size() == scene->drawn_instance_count;
+    if (!is_view_unchanged) {
+        SetFrameUpdate(renderer, FrameUpdate::Full);
+    } else if (scene->moved_instances.empty()) {
+        SetFrameUpdate(renderer, FrameUpdate::Reuse);
+    } else {
+        SetFrameUpdate(renderer, FrameUpdate::DirtyTiles);
+    }
+
+    // Where a moved instance was and where it is now.
+    if (renderer->frame_update == FrameUpdate::DirtyTiles) {
+        for (u32 instance_index : scene->moved_instances) {
+            MeshInstance const& instance = scene->instances[instance_index];
+            vec2f old_min, old_max, new_min, new_max;
+            if (!GetScreenBounds(renderer, instance.drawn_bounds, view_projection, old_min, old_max) ||
+                !GetScreenBounds(renderer, instance.world_bounds, view_projection, new_min, new_max)) {
+                SetFrameUpdate(renderer, FrameUpdate::Full);
+                break;
+            }
+            MarkDirtyRect(renderer, old_min, old_max);
+            MarkDirtyRect(renderer, new_min, new_max);
+        }
+    }
+
+    for (u32 instance_index : scene->moved_instances) {
+        MeshInstance& instance = scene->instances[instance_index];
+        instance.drawn_bounds = instance.world_bounds;
+        instance.drawn_mesh_version = instance.mesh->version;
+    }
+    scene->has_drawn_frame = true;
+    scene->drawn_view_projection = view_projection;
+    scene->drawn_lod_pixel_error = scene->lod_pixel_error;
+    scene->drawn_show_wireframe = scene->show_wireframe;
+    scene->drawn_instance_count = scene->instances.size();
+}
+
+void DrawScene(Renderer* renderer, Scene* scene, FlyingCameraController const* camera) {
+    UpdateSceneBVH(scene);
+
+    glm::mat4 view_projection = get_flying_camera_projection(camera, renderer->aspect_ratio) * camera->view_transform;
+    CullScene(scene, ExtractFrustum(view_projection));
+
+    f32 projection_scale = GetProjectionScale(camera->fov_y, renderer->fBuffer_heigth);
+
+    scene->draw_items.clear();
+    for (u32 instance_index : scene->visible_instances) {
+        MeshInstance const& instance = scene->instances[instance_index];
+
+        // Closest point of the bounds, so the LOD never gets coarser than what the nearest part of the mesh allows.
+        vec3f closest_point = glm::clamp(camera->position, instance.world_bounds.min, instance.world_bounds.max);
+        f32 distance = glm::distance(camera->position, closest_point);
+        f32 error_scale =
+            std::max({glm::length(vec3f(instance.transform[0])), glm::length(vec3f(instance.transform[1])),
+                      glm::length(vec3f(instance.transform[2]))});
+
+        u32 lod = SelectMeshLod(instance.mesh, error_scale, distance, projection_scale, scene->lod_pixel_error);
+        scene->draw_items.push_back({instance.mesh, lod, instance_index});
+    }
+
+    std::sort(scene->draw_items.begin(), scene->draw_items.end(), [](SceneDrawItem const& a, SceneDrawItem const& b) {
+        return a.mesh != b.mesh ? a.mesh < b.mesh : a.lod < b.lod;
+    });
+
+    // One instanced draw per (mesh, LOD) run. With a prepass, depth for the whole scene goes first and the color pass
+    // then shades only the front-most surface. The wireframe goes last, tested against the finished depth.
+    u32 const shaded_pass_count = scene->use_depth_prepass ? 2 : 1;
+    u32 const pass_count = shaded_pass_count + (scene->show_wireframe ? 1 : 0);
+    for (u32 pass = 0; pass < pass_count; ++pass) {
+        DrawMode mode = DrawMode::Color;
+        if (pass == shaded_pass_count) {
+            mode = DrawMode::Wireframe;
+        } else if (scene->use_depth_prepass) {
+            mode = pass == 0 ? DrawMode::DepthOnly : DrawMode::ColorEqualDepth;
+        }
+
+        for (size_t first = 0; first < scene->draw_items.size();) {
+            SceneDrawItem const& item = scene->draw_items[first];
+            scene->draw_transforms.clear();
+
+            size_t last = first;
+            while (last < scene->draw_items.size() && scene->draw_items[last].mesh == item.mesh &&
+                   scene->draw_items[last].lod == item.lod) {
+                scene->draw_transforms.push_back(scene->instances[scene->draw_items[last].instance_index].transform);
+                ++last;
+            }
+
+            DrawMeshInstanced(renderer, item.mesh, view_projection, scene->draw_transforms.data(),
+                              scene->draw_transforms.size(), item.lod, mode);
+            first = last;
+        }
+    }
+}
+
+} // namespace gfx
@@ -0,0 +1,102 @@
+#pragma once
+#include "flying_camera_controller.h"
+#include "mesh.h"
+#include "types.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace gfx {
+
+struct Renderer;
+
+static constexpr u32 BVH_INVALID_INDEX = 0xFFFFFFFF;
+
+struct MeshInstance {
+    Mesh* mesh = nullptr;
+    glm::mat4 transform = glm::mat4(1.0f);
+    // Mesh bounds transformed to world-space.
+    AABB world_bounds;
+    // Leaf node holding this instance.
+    u32 bvh_leaf = BVH_INVALID_INDEX;
+    // World bounds and mesh version the last drawn frame saw.
+    AABB drawn_bounds;
+    u32 drawn_mesh_version = 0;
+};
+
+struct BVHNode {
+    AABB bounds;
+    u32 parent = BVH_INVALID_INDEX;
+    // Children are BVH_INVALID_INDEX for leaves.
+    u32 left = BVH_INVALID_INDEX;
+    u32 right = BVH_INVALID_INDEX;
+    // Only valid for leaves.
+    u32 instance_index = BVH_INVALID_INDEX;
+};
+
+struct SceneDrawItem {
+    Mesh* mesh;
+    u32 lod;
+    u32 instance_index;
+};
+
+struct Scene {
+    std::vector<MeshInstance> instances;
+
+    // BVH over instance world bounds, one instance per leaf.
+    std::vector<BVHNode> bvh_nodes;
+    u32 bvh_root = BVH_INVALID_INDEX;
+    bool bvh_needs_rebuild = true;
+    // Summed surface area of the inner nodes, which tracks the cost of walking the tree. Refits keep it current, and
+    // the tree is rebuilt once the instances have moved far enough to loosen it well past its value after the build.
+    f32 bvh_inner_area = 0.0f;
+    f32 bvh_built_inner_area = 0.0f;
+    // Instances moved since the last update, their leaves need to be refit.
+    std::vector<u32> moved_instances;
+
+    // Output of CullScene
+    std::vector<u32> visible_instances;
+
+    // Largest screen-space error (in pixels) a LOD may introduce.
+    f32 lod_pixel_error = 1.0f;
+    // Lay down depth for every visible instance before shading any of them.
+    bool use_depth_prepass = false;
+    // Draw the triangle edges of every visible instance over the shaded scene. Needs immediate-mode drawing, so it's
+    // skipped when the renderer is pipelined.
+    bool show_wireframe = false;
+
+    // DrawScene scratch, visible instances grouped by (mesh, LOD) into instanced draws.
+    std::vector<SceneDrawItem> draw_items;
+    std::vector<glm::mat4> draw_transforms;
+
+    // Change tracking, what the last drawn frame was drawn with.
+    bool has_drawn_frame = false;
+    glm::mat4 drawn_view_projection = glm::mat4(1.0f);
+    f32 drawn_lod_pixel_error = 0.0f;
+    bool drawn_show_wireframe = false;
+    size_t drawn_instance_count = 0;
+};
+
+// Planes are stored as (normal, d) with normals pointing inside, a point p is inside when dot(n, p) + d >= 0.
+struct Frustum {
+    vec4f planes[6];
+};
+
+u32 AddMeshInstance(Scene* scene, Mesh* mesh, glm::mat4 const& transform);
+void SetMeshInstanceTransform(Scene* scene, u32 instance_index, glm::mat4 const& transform);
+
+void BuildSceneBVH(Scene* scene);
+void RefitSceneBVH(Scene* scene);
+// Rebuilds or refits the BVH depending on what changed since the last call.
+void UpdateSceneBVH(Scene* scene);
+
+Frustum ExtractFrustum(glm::mat4 const& view_projection);
+
+// Walks the BVH and fills scene->visible_instances.
+void CullScene(Scene* scene, Frustum const& frustum);
+// Compares the camera, meshes and instances against the last frame and picks the renderer's frame update: reuse the
+// previous image, redraw the tiles under the old and new screen bounds of what moved, or redraw everything. Call
+// before ClearBuffers.
+void TrackSceneChanges(Renderer* renderer, Scene* scene, FlyingCameraController const* camera);
+void DrawScene(Renderer* renderer, Scene* scene, FlyingCameraController const* camera);
+
+} // namespace gfx
@@ -0,0 +1,429 @@
+#include "sort_last.h"
+#include "logger.h"
+#include "renderer.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GFX_SSE2 1
+#endif
+
+namespace gfx {
+
+// The flags live in memory mapped by several processes, they have to be lock-free to work across them.
+static_assert(std::atomic<u32>::is_always_lock_free);
+
+// Layers start on cache lines so no two processes ever write the same line.
+static constexpr size_t SORT_LAST_ALIGNMENT = 64;
+
+static size_t AlignSize(size_t size) { return (size + SORT_LAST_ALIGNMENT - 1) & ~(SORT_LAST_ALIGNMENT - 1); }
+
+static size_t GetLayerPlaneSize(size_t width, size_t height) { return AlignSize(width * height * sizeof(u32)); }
+
+static size_t GetMappingSize(u32 process_count, size_t width, size_t height) {
+    // Color and w planes are both 32 bits per pixel.
+    return AlignSize(sizeof(SortLastHeader)) + (size_t)process_count * 2 * GetLayerPlaneSize(width, height);
+}
+
+static void SetLayerPointers(SortLast* sort_last) {
+    size_t const plane_size = GetLayerPlaneSize(sort_last->width, sort_last->height);
+    u8* data = static_cast<u8*>(sort_last->mapping) + AlignSize(sizeof(SortLastHeader));
+    for (u32 i = 0; i < sort_last->process_count; ++i) {
+        sort_last->layers[i].color_buffer = reinterpret_cast<u32*>(data);
+        sort_last->layers[i].w_buffer = reinterpret_cast<f32*>(data + plane_size);
+        data += 2 * plane_size;
+    }
+}
+
+static u64 GetOwnProcessId() {
+#ifdef _WIN32
+    return (u64)GetCurrentProcessId();
+#else
+    return (u64)getpid();
+#endif
+}
+
+static bool MapSharedMemory(SortLast* sort_last, bool create) {
+#ifdef _WIN32
+    if (create) {
+        sort_last->mapping_handle =
+            CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                               (DWORD)((u64)sort_last->mapping_size >> 32),
+                               (DWORD)(sort_last->mapping_size & 0xFFFFFFFF), sort_last->shared_memory_name);
+    } else {
+        sort_last->mapping_handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, sort_last->shared_memory_name);
+    }
+    if (sort_last->mapping_handle == nullptr) {
+        gfx_error("Shared memory {0} could not be opened: {1}", sort_last->shared_memory_name, GetLastError());
+        return false;
+    }
+    sort_last->mapping = MapViewOfFile(sort_last->mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, sort_last->mapping_size);
+    if (sort_last->mapping == nullptr) {
+        gfx_error("Shared memory {0} could not be mapped: {1}", sort_last->shared_memory_name, GetLastError());
+        return false;
+    }
+#else
+    int const fd = shm_open(sort_last->shared_memory_name, create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) {
+        gfx_error("Shared memory {0} could not be opened: {1}", sort_last->shared_memory_name, strerror(errno));
+        return false;
+    }
+    if (create && ftruncate(fd, (off_t)sort_last->mapping_size) != 0) {
+        gfx_error("Shared memory {0} could not be sized: {1}", sort_last->shared_memory_name, strerror(errno));
+        close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sort_last->mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        gfx_error("Shared memory {0} could not be mapped: {1}", sort_last->shared_memory_name, strerror(errno));
+        return false;
+    }
+    sort_last->mapping = mapping;
+#endif
+    return true;
+}
+
+static bool LaunchRendererProcess(SortLast* sort_last, u32 process_index, int argc, char** argv) {
+    std::string const index = std::to_string(process_index);
+#ifdef _WIN32
+    // Same command line, the extra flags come last so they win over anything the user passed.
+    std::string command_line = GetCommandLineA();
+    command_line += " --sort-last-process " + index + " --sort-last-shm " + sort_last->shared_memory_name;
+
+    STARTUPINFOA startup_info{};
+    startup_info.cb = sizeof(startup_info);
+    PROCESS_INFORMATION process_info{};
+    if (!CreateProcessA(nullptr, command_line.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup_info,
+                        &process_info)) {
+        gfx_error("Renderer process {0} could not be started: {1}", process_index, GetLastError());
+        return false;
+    }
+    CloseHandle(process_info.hThread);
+    sort_last->process_handles[process_index] = process_info.hProcess;
+#else
+    std::vector<char*> arguments(argv, argv + argc);
+    char process_flag[] = "--sort-last-process";
+    char shm_flag[] = "--sort-last-shm";
+    arguments.push_back(process_flag);
+    arguments.push_back(const_cast<char*>(index.c_str()));
+    arguments.push_back(shm_flag);
+    arguments.push_back(sort_last->shared_memory_name);
+    arguments.push_back(nullptr);
+
+    pid_t process_id = 0;
+    int const result = posix_spawnp(&process_id, argv[0], nullptr, nullptr, arguments.data(), environ);
+    if (result != 0) {
+        gfx_error("Renderer process {0} could not be started: {1}", process_index, strerror(result));
+        return false;
+    }
+    sort_last->process_ids[process_index] = process_id;
+#endif
+    return true;
+}
+
+// Compositor side, whether a renderer process is still running. Reaps it if it isn't.
+static bool IsRendererProcessRunning(SortLast* sort_last, u32 process_index) {
+#ifdef _WIN32
+    void* handle = sort_last->process_handles[process_index];
+    return handle != nullptr && WaitForSingleObject(handle, 0) == WAIT_TIMEOUT;
+#else
+    pid_t const process_id = sort_last->process_ids[process_index];
+    if (process_id <= 0)
+        return false;
+    if (waitpid(process_id, nullptr, WNOHANG) == 0)
+        return true;
+    sort_last->process_ids[process_index] = 0;
+    return false;
+#endif
+}
+
+static bool IsCompositorRunning(SortLast const* sort_last) {
+    u64 const process_id = sort_last->header->compositor_process_id;
+#ifdef _WIN32
+    HANDLE handle = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)process_id);
+    if (handle == nullptr)
+        return false;
+    bool const is_running = WaitForSingleObject(handle, 0) == WAIT_TIMEOUT;
+    CloseHandle(handle);
+    return is_running;
+#else
+    return kill((pid_t)process_id, 0) == 0 || errno == EPERM;
+#endif
+}
+
+bool StartSortLast(SortLast* sort_last, u32 process_count, size_t width, size_t height, int argc, char** argv) {
+    if (process_count < 2 || process_count > SORT_LAST_MAX_PROCESSES) {
+        gfx_error("Sort-last needs 2 to {0} processes, got {1}.", SORT_LAST_MAX_PROCESSES, process_count);
+        return false;
+    }
+
+    sort_last->process_index = 0;
+    sort_last->process_count = process_count;
+    sort_last->width = width;
+    sort_last->height = height;
+    sort_last->frame_index = 0;
+    sort_last->mapping_size = GetMappingSize(process_count, width, height);
+#ifdef _WIN32
+    std::snprintf(sort_last->shared_memory_name, sizeof(sort_last->shared_memory_name), "Local\\csgfx-sort-last-%llu",
+                  (unsigned long long)GetOwnProcessId());
+#else
+    std::snprintf(sort_last->shared_memory_name, sizeof(sort_last->shared_memory_name), "/csgfx-sort-last-%llu",
+                  (unsigned long long)GetOwnProcessId());
+#endif
+
+    if (!MapSharedMemory(sort_last, true)) {
+        StopSortLast(sort_last);
+        return false;
+    }
+
+    SortLastHeader* header = new (sort_last->mapping) SortLastHeader{};
+    header->width = (u32)width;
+    header->height = (u32)height;
+    header->process_count = process_count;
+    header->compositor_process_id = GetOwnProcessId();
+    sort_last->header = header;
+    SetLayerPointers(sort_last);
+
+    for (u32 i = 1; i < process_count; ++i) {
+        if (!LaunchRendererProcess(sort_last, i, argc, argv)) {
+            StopSortLast(sort_last);
+            return false;
+        }
+    }
+    gfx_info("Sort-last rendering with {0} processes through {1}.", process_count, sort_last->shared_memory_name);
+    return true;
+}
+
+bool AttachSortLast(SortLast* sort_last, char const* shared_memory_name, u32 process_index) {
+    if (process_index == 0) {
+        gfx_error("Sort-last process 0 is the compositor.");
+        return false;
+    }
+    sort_last->process_index = process_index;
+    std::snprintf(sort_last->shared_memory_name, sizeof(sort_last->shared_memory_name), "%s", shared_memory_name);
+
+    // The layer size is only known once the header is readable, map it alone first.
+    sort_last->mapping_size = sizeof(SortLastHeader);
+    if (!MapSharedMemory(sort_last, false)) {
+        StopSortLast(sort_last);
+        return false;
+    }
+    SortLastHeader const* header = static_cast<SortLastHeader const*>(sort_last->mapping);
+    size_t const width = header->width;
+    size_t const height = header->height;
+    u32 const process_count = header->process_count;
+    StopSortLast(sort_last);
+
+    if (process_index >= process_count) {
+        gfx_error("Sort-last process index {0} is out of range, there are {1} processes.", process_index,
+                  process_count);
+        return false;
+    }
+
+    std::snprintf(sort_last->shared_memory_name, sizeof(sort_last->shared_memory_name), "%s", shared_memory_name);
+    sort_last->process_count = process_count;
+    sort_last->width = width;
+    sort_last->height = height;
+    sort_last->mapping_size = GetMappingSize(process_count, width, height);
+    if (!MapSharedMemory(sort_last, false)) {
+        StopSortLast(sort_last);
+        return false;
+    }
+
+    sort_last->header = static_cast<SortLastHeader*>(sort_last->mapping);
+    sort_last->frame_index = sort_last->header->finished_frames[process_index].load(std::memory_order_relaxed);
+    SetLayerPointers(sort_last);
+    return true;
+}
+
+void StopSortLast(SortLast* sort_last) {
+    bool const is_compositor = sort_last->header != nullptr && sort_last->process_index == 0;
+    if (is_compositor) {
+        sort_last->header->is_shutting_down.store(1, std::memory_order_release);
+        for (u32 i = 1; i < sort_last->process_count; ++i) {
+#ifdef _WIN32
+            if (sort_last->process_handles[i] != nullptr) {
+                WaitForSingleObject(sort_last->process_handles[i], INFINITE);
+                CloseHandle(sort_last->process_handles[i]);
+                sort_last->process_handles[i] = nullptr;
+            }
+#else
+            if (sort_last->process_ids[i] > 0) {
+                waitpid(sort_last->process_ids[i], nullptr, 0);
+                sort_last->process_ids[i] = 0;
+            }
+#endif
+        }
+    }
+
+#ifdef _WIN32
+    if (sort_last->mapping != nullptr) {
+        UnmapViewOfFile(sort_last->mapping);
+    }
+    if (sort_last->mapping_handle != nullptr) {
+        CloseHandle(sort_last->mapping_handle);
+        sort_last->mapping_handle = nullptr;
+    }
+#else
+    if (sort_last->mapping != nullptr) {
+        munmap(sort_last->mapping, sort_last->mapping_size);
+    }
+    // The name goes away once the renderer processes have it mapped or are gone, the memory lives until the last unmap.
+    if (sort_last->process_index == 0 && sort_last->shared_memory_name[0] != '\0') {
+        shm_unlink(sort_last->shared_memory_name);
+    }
+#endif
+
+    sort_last->header = nullptr;
+    sort_last->mapping = nullptr;
+    sort_last->mapping_size = 0;
+    sort_last->shared_memory_name[0] = '\0';
+    for (SortLastLayer& layer : sort_last->layers) {
+        layer = SortLastLayer{};
+    }
+}
+
+// Spins, then sleeps between polls. Gives up when `is_done` is still false and `is_alive` says the other side is gone.
+template <typename Done, typename Alive> static bool WaitForSortLastFlag(Done const& is_done, Alive const& is_alive) {
+    u32 spins = 0;
+    while (!is_done()) {
+        if (++spins < SORT_LAST_SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!is_alive())
+            return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(SORT_LAST_SLEEP_MICROSECONDS));
+    }
+    return true;
+}
+
+void BeginSortLastFrame(SortLast* sort_last, SortLastFrame const& frame) {
+    SortLastHeader* header = sort_last->header;
+    header->frame = frame;
+    header->frame_index.store(++sort_last->frame_index, std::memory_order_release);
+}
+
+bool WaitForSortLastFrame(SortLast* sort_last, SortLastFrame* frame) {
+    SortLastHeader* header = sort_last->header;
+    bool const has_frame = WaitForSortLastFlag(
+        [header, sort_last] {
+            return header->is_shutting_down.load(std::memory_order_acquire) != 0 ||
+                   header->frame_index.load(std::memory_order_acquire) != sort_last->frame_index;
+        },
+        [sort_last] { return IsCompositorRunning(sort_last); });
+    if (!has_frame || header->is_shutting_down.load(std::memory_order_acquire) != 0)
+        return false;
+
+    // The compositor doesn't touch `frame` again until every process has finished this one.
+    sort_last->frame_index = header->frame_index.load(std::memory_order_acquire);
+    *frame = header->frame;
+    return true;
+}
+
+void WriteSortLastLayer(SortLast* sort_last, Renderer* renderer) {
+    SortLastLayer const& layer = sort_last->layers[sort_last->process_index];
+    size_t const width = sort_last->width;
+    auto write_rows = [renderer, &layer, width](size_t first_row, size_t last_row, u32) {
+        for (size_t y = first_row; y < last_row; ++y) {
+            std::memcpy(layer.color_buffer + y * width, renderer->color_buffer + y * renderer->color_buffer_stride,
+                        width * sizeof(u32));
+        }
+        ResolveDepthRows(&renderer->depth_buffer, first_row, last_row, layer.w_buffer + first_row * width, width);
+    };
+    ParallelFor(&renderer->job_system, sort_last->height, L1_TILE_SIZE, write_rows);
+
+    sort_last->header->finished_frames[sort_last->process_index].store(sort_last->frame_index,
+                                                                       std::memory_order_release);
+}
+
+// Keeps the nearest layer of each pixel, the lowest process index on ties.
+static void CompositeRows(SortLast const* sort_last, u32* target, size_t target_stride, size_t first_row,
+                          size_t last_row) {
+    size_t const width = sort_last->width;
+    u32 const layer_count = sort_last->process_count;
+    SortLastLayer const* layers = sort_last->layers;
+
+    for (size_t y = first_row; y < last_row; ++y) {
+        size_t const row_offset = y * width;
+        u32* target_row = target + y * target_stride;
+        size_t x = 0;
+#ifdef GFX_SSE2
+        for (; x + 4 <= width; x += 4) {
+            size_t const offset = row_offset + x;
+            __m128 nearest_w = _mm_loadu_ps(layers[0].w_buffer + offset);
+            __m128i color = _mm_loadu_si128(reinterpret_cast<__m128i const*>(layers[0].color_buffer + offset));
+            for (u32 layer = 1; layer < layer_count; ++layer) {
+                __m128 const w = _mm_loadu_ps(layers[layer].w_buffer + offset);
+                __m128i const layer_color =
+                    _mm_loadu_si128(reinterpret_cast<__m128i const*>(layers[layer].color_buffer + offset));
+                __m128i const is_nearer = _mm_castps_si128(_mm_cmpgt_ps(w, nearest_w));
+                color = _mm_or_si128(_mm_and_si128(is_nearer, layer_color), _mm_andnot_si128(is_nearer, color));
+                nearest_w = _mm_max_ps(w, nearest_w);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target_row + x), color);
+        }
+#endif
+        for (; x < width; ++x) {
+            size_t const offset = row_offset + x;
+            f32 nearest_w = layers[0].w_buffer[offset];
+            u32 color = layers[0].color_buffer[offset];
+            for (u32 layer = 1; layer < layer_count; ++layer) {
+                f32 const w = layers[layer].w_buffer[offset];
+                if (w > nearest_w) {
+                    nearest_w = w;
+                    color = layers[layer].color_buffer[offset];
+                }
+            }
+            target_row[x] = color;
+        }
+    }
+}
+
+bool CompositeSortLast(SortLast* sort_last, Renderer* renderer) {
+    SortLastHeader* header = sort_last->header;
+    for (u32 i = 1; i < sort_last->process_count; ++i) {
+        bool const is_finished = WaitForSortLastFlag(
+            [header, sort_last, i] {
+                return header->finished_frames[i].load(std::memory_order_acquire) == sort_last->frame_index;
+            },
+            [sort_last, i] { return IsRendererProcessRunning(sort_last, i); });
+        if (!is_finished) {
+            gfx_error("Sort-last renderer process {0} exited.", i);
+            return false;
+        }
+    }
+
+    // Bands of L1 tile rows, every layer row is read once per band.
+    u32* target = renderer->color_buffer;
+    size_t const target_stride = renderer->color_buffer_stride;
+    auto composite_rows = [sort_last, target, target_stride](size_t first_row, size_t last_row, u32) {
+        CompositeRows(sort_last, target, target_stride, first_row, last_row);
+    };
+    ParallelFor(&renderer->job_system, sort_last->height, L1_TILE_SIZE, composite_rows);
+    return true;
+}
+
+} // namespace gfx
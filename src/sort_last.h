@@ -0,0 +1,93 @@
+#pragma once
+#include "flying_camera_controller.h"
+#include "types.h"
+#include <atomic>
+
+namespace gfx {
+
+struct Renderer;
+
+// Sort-last rendering across processes on one machine. Every process draws its share of the scene's instances at full
+// resolution into its own layer, a color buffer and a w buffer in shared memory, and the compositor (process 0) keeps
+// the nearest layer of every pixel.
+static constexpr u32 SORT_LAST_MAX_PROCESSES = 16;
+// Polls of a frame flag before a waiting process starts sleeping between polls and checking on the other side.
+static constexpr u32 SORT_LAST_SPIN_COUNT = 256;
+static constexpr u32 SORT_LAST_SLEEP_MICROSECONDS = 100;
+
+// What the renderer processes need to draw a frame, written by the compositor before it starts one.
+struct SortLastFrame {
+    FlyingCameraController camera;
+    f32 lod_pixel_error = 1.0f;
+    bool use_depth_prepass = false;
+};
+
+// Start of the shared memory, the layers follow it.
+struct SortLastHeader {
+    u32 width;
+    u32 height;
+    u32 process_count;
+    u64 compositor_process_id;
+    SortLastFrame frame;
+    // Bumped by the compositor once `frame` is written, 0 before the first frame.
+    std::atomic<u32> frame_index;
+    // Last frame index each process has written its layer for.
+    std::atomic<u32> finished_frames[SORT_LAST_MAX_PROCESSES];
+    std::atomic<u32> is_shutting_down;
+};
+
+// One process' image, width x height pixels with no padding. The w buffer holds 1/w like the depth buffer: 0 where
+// nothing was drawn, larger is nearer.
+struct SortLastLayer {
+    u32* color_buffer = nullptr;
+    f32* w_buffer = nullptr;
+};
+
+struct SortLast {
+    SortLastHeader* header = nullptr;
+    SortLastLayer layers[SORT_LAST_MAX_PROCESSES];
+    // 0 is the compositor.
+    u32 process_index = 0;
+    u32 process_count = 1;
+    size_t width = 0;
+    size_t height = 0;
+    // Last frame this process started (compositor) or rendered.
+    u32 frame_index = 0;
+
+    char shared_memory_name[64] = {};
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+    void* process_handles[SORT_LAST_MAX_PROCESSES] = {};
+#else
+    s32 process_ids[SORT_LAST_MAX_PROCESSES] = {};
+#endif
+};
+
+// Compositor side. Creates the shared memory for `process_count` layers of width x height and relaunches this
+// executable `process_count - 1` times with the original arguments plus --sort-last-process and --sort-last-shm.
+bool StartSortLast(SortLast* sort_last, u32 process_count, size_t width, size_t height, int argc, char** argv);
+// Renderer process side, maps the shared memory the compositor created.
+bool AttachSortLast(SortLast* sort_last, char const* shared_memory_name, u32 process_index);
+// The compositor tells the renderer processes to exit and waits for them, then unmaps and removes the shared memory.
+// Renderer processes only unmap it.
+void StopSortLast(SortLast* sort_last);
+
+// Instances are dealt out round-robin.
+__forceinline bool IsSortLastShare(SortLast const* sort_last, u32 instance_index) {
+    return instance_index % sort_last->process_count == sort_last->process_index;
+}
+
+// Compositor, starts a frame on every renderer process.
+void BeginSortLastFrame(SortLast* sort_last, SortLastFrame const& frame);
+// Renderer process, blocks until the compositor starts a frame. False once it shuts down or goes away.
+bool WaitForSortLastFrame(SortLast* sort_last, SortLastFrame* frame);
+// Copies the renderer's finished frame into this process' layer and marks the frame done. The render resolution must
+// be the layer size.
+void WriteSortLastLayer(SortLast* sort_last, Renderer* renderer);
+// Compositor, waits for every layer of the current frame and merges them into the renderer's color buffer. Call after
+// WriteSortLastLayer. False when a renderer process died.
+bool CompositeSortLast(SortLast* sort_last, Renderer* renderer);
+
+} // namespace gfx